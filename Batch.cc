@@ -0,0 +1,274 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Batch.h"
+#include "Search.h"
+#include "Subject.h"
+#include "Trace.h"
+#include "RegexStd.h"
+#include "RegexQt.h"
+#ifdef PCRE2_REGEX
+    #include "RegexPcre.h"
+#endif
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <fmt/core.h>
+
+namespace batch {
+    namespace {
+        using clock = std::chrono::steady_clock;
+
+        double ms(clock::duration const d) noexcept {
+            return std::chrono::duration<double, std::milli>(d).count();
+        }
+
+        /// Sink which keeps all lines (as the matches-view would show them).
+        struct Collect : Sink {
+            strings lines{};
+            void line(std::string const& text, int) override {
+                lines.push_back(text);
+            }
+            void highlight(Match&&) override {}
+        };
+
+        /// Not empty lines, as they are saved from the matches-view.
+        strings normalized(strings const& lines) {
+            strings buffer;
+            for (auto const& line : lines) {
+                std::istringstream stream(line);
+                for (std::string part; std::getline(stream, part);)
+                    if (qstr::fromStdString(part).trimmed().size())
+                        buffer.push_back(std::move(part));
+            }
+            return buffer;
+        }
+
+        /// Sources of the run - the same as the GUI makes from the source-editor.
+        template<typename Subject, typename... Args>
+        std::vector<Subject> subjects(qstrings const& lines, bool const document, Args... args) {
+            std::vector<Subject> buffer;
+            if (document) {
+                buffer.emplace_back(lines.join('\n'), 0, args..., Scope::Document);
+                return buffer;
+            }
+            buffer.reserve(lines.size());
+            for (int i = 0; i < lines.size(); ++i)
+                if (not lines[i].trimmed().isEmpty())
+                    buffer.emplace_back(lines[i], i, args..., Scope::Line);
+            return buffer;
+        }
+
+        bool captures(Granularity const granularity) noexcept {
+            return granularity == Granularity::Offsets
+                or granularity == Granularity::Full
+                or granularity == Granularity::GroupBy;
+        }
+
+        /// Run with compiled patterns (compilation is timed).
+        /// \return the run or nullptr with the error.
+        std::unique_ptr<Run> prepare(std::string const& engine, qstrings const& patterns, qstrings const& lines,
+                                     Options const& options, clock::duration& compile, std::string& error)
+        {
+            auto const granularity = options.granularity;
+            auto const full = captures(granularity);
+
+            if (engine == "std") {
+                auto opt = std::regex_constants::ECMAScript;
+                if (options.icase) opt |= std::regex_constants::icase;
+                if (options.document) opt |= std::regex_constants::multiline;
+                if (not full) opt |= std::regex_constants::nosubs;
+                auto search = std::make_unique<Search<RegexStd, Utf8Subject>>(
+                        granularity, subjects<Utf8Subject>(lines, options.document, Utf8Subject::Kind::Text));
+                auto const start = clock::now();
+                for (auto const& pattern : patterns) {
+                    auto const begin = clock::now();
+                    auto rgx = std::make_unique<RegexStd const>(pattern.toStdString(), opt);
+                    search->add(pattern, std::move(rgx), {}, {}, Compiled::since(begin));
+                }
+                compile = clock::now() - start;
+                return search;
+            }
+            if (engine == "qt") {
+                QRegularExpression::PatternOptions opts;
+                if (options.icase) opts |= QRegularExpression::CaseInsensitiveOption;
+                if (options.document) opts |= QRegularExpression::MultilineOption;
+                if (not full) opts |= QRegularExpression::DontCaptureOption;
+                auto search = std::make_unique<Search<RegexQt, Utf16Subject>>(
+                        granularity, subjects<Utf16Subject>(lines, options.document));
+                auto const start = clock::now();
+                for (auto const& pattern : patterns) {
+                    // Not from the cache - every file pays for its compilation.
+                    auto const begin = clock::now();
+                    auto rgx = std::make_unique<RegexQt const>(pattern, opts);
+                    if (not rgx->valid()) {
+                        error = rgx->error().toStdString();
+                        return {};
+                    }
+                    search->add(pattern, std::move(rgx), {}, {}, Compiled::since(begin));
+                }
+                compile = clock::now() - start;
+                return search;
+            }
+#ifdef PCRE2_REGEX
+            if (engine == "pcre2") {
+                u32 opts = PCRE2_UTF;
+                if (options.icase) opts |= PCRE2_CASELESS;
+                if (options.document) opts |= PCRE2_MULTILINE;
+                if (not full) opts |= PCRE2_NO_AUTO_CAPTURE;
+                // UTF-16 as in the GUI - positions in results are the same.
+                auto search = std::make_unique<Search<RegexPcre16, Utf16Subject>>(
+                        granularity, subjects<Utf16Subject>(lines, options.document));
+                auto const start = clock::now();
+                for (auto const& pattern : patterns) {
+                    auto const begin = clock::now();
+                    auto const data = reinterpret_cast<char16_t const*>(pattern.utf16());
+                    auto rgx = std::make_unique<RegexPcre16 const>(data, std::size_t(pattern.size()), opts);
+                    if (not rgx->valid()) {
+                        error = rgx->error();
+                        return {};
+                    }
+                    search->add(pattern, std::move(rgx), {}, {}, Compiled::since(begin));
+                }
+                compile = clock::now() - start;
+                return search;
+            }
+#endif
+            error = fmt::format("unknown engine '{}'", engine);
+            return {};
+        }
+    }
+
+    Result run(std::string const& file, Content const& content, std::string const& engine, Options const& options) {
+        Result result{.file = file, .engine = engine};
+
+        qstrings patterns;
+        for (auto const& text : content.regex)
+            if (auto pattern = qstr::fromStdString(text); not pattern.trimmed().isEmpty())
+                patterns.push_back(std::move(pattern));
+        qstrings lines;
+        for (auto const& text : content.source) {
+            lines.push_back(qstr::fromStdString(text));
+            result.bytes += isize(text.size());
+        }
+        result.patterns = patterns.size();
+        result.lines = lines.size();
+
+        clock::duration compile{};
+        std::unique_ptr<Run> run;
+        try {
+            run = prepare(engine, patterns, lines, options, compile, result.error);
+        }
+        catch (std::exception const& e) {
+            result.error = e.what();
+        }
+        if (not run)
+            return result;
+        result.compile_ms = ms(compile);
+
+        Collect sink;
+        auto const start = clock::now();
+        try {
+            run->scan(sink);
+        }
+        catch (std::exception const& e) {
+            result.error = e.what();
+        }
+        auto const elapsed = clock::now() - start;
+        result.match_ms = ms(elapsed);
+        result.matches = run->found();
+        result.stats = run->stats();
+        if (auto const seconds = result.match_ms / 1000; seconds > 0) {
+            result.mb_per_s = double(result.bytes) / (1024.0 * 1024.0) / seconds;
+            result.matches_per_s = double(result.matches) / seconds;
+        }
+
+        auto produced = normalized(sink.lines);
+        if (options.check and not content.matches.empty()) {
+            auto const expected = normalized(content.matches);
+            auto const [e, p] = std::ranges::mismatch(expected, produced);
+            result.passed = e == expected.end() and p == produced.end();
+            if (not *result.passed)
+                result.mismatch = fmt::format("line {}: expected '{}', got '{}'",
+                                              std::distance(expected.begin(), e) + 1,
+                                              e == expected.end() ? "" : *e,
+                                              p == produced.end() ? "" : *p);
+        }
+        if (options.results)
+            result.results = std::move(produced);
+        return result;
+    }
+
+    std::vector<Result> run_all(strings const& files, Options const& options) {
+        // Every file is read and parsed only once.
+        std::vector<std::optional<Content>> contents;
+        contents.reserve(files.size());
+        for (auto const& file : files) {
+            std::ifstream in(file);
+            if (not in.is_open()) {
+                contents.emplace_back();
+                continue;
+            }
+            std::string const json{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+            contents.push_back(Content::from_json(json));
+        }
+
+        auto const engines = options.engines.size();
+        std::vector<Result> results(files.size() * engines);
+        if (results.empty())
+            return results;
+        std::atomic<std::size_t> next{};
+        auto const work = [&] {
+            for (auto i = next++; i < results.size(); i = next++) {
+                auto const& file = files[i / engines];
+                auto const& engine = options.engines[i % engines];
+                if (auto const& content = contents[i / engines]; content) {
+                    auto const begin = clock::now();
+                    results[i] = run(file, *content, engine, options);
+                    if (trace::recording.load(std::memory_order_relaxed))
+                        trace::record(fmt::format("{} [{}]", file, engine), "batch", begin, clock::now());
+                }
+                else
+                    results[i] = Result{.file = file, .engine = engine, .error = "can't read or parse the file"};
+            }
+        };
+
+        std::vector<std::jthread> workers;
+        auto const n = std::clamp<std::size_t>(options.jobs, 1, results.size());
+        for (std::size_t i = 1; i < n; ++i)
+            workers.emplace_back([&work, i] {
+                trace::name_thread(fmt::format("job {}", i));
+                work();
+            });
+        work();
+        // Joined before the results leave (without NRVO they would be moved while workers write).
+        workers.clear();
+        return results;
+    }
+}
@@ -0,0 +1,105 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include "Content.h"
+#include "model/Stats.h"
+#include <glaze/glaze.hpp>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*------- headless runs:
+-------------------------------------------------------------------*/
+/// Runs of saved .crgx files without the GUI (regression suites in scripts). \n
+/// Every file is run with every selected engine, runs are executed in parallel.
+namespace batch {
+    struct Options {
+        strings engines{"std", "qt", "pcre2"};
+        Granularity granularity{Granularity::Full};
+        bool icase{};
+        bool document{};
+        bool results{true};     // produced lines are included in the report
+        bool check{true};       // produced lines are compared with matches stored in the file
+        unsigned jobs{std::thread::hardware_concurrency()};
+    };
+
+    /// Report of one file run with one engine.
+    struct Result {
+        std::string file{};
+        std::string engine{};
+        isize patterns{};
+        isize lines{};
+        isize bytes{};
+        isize matches{};
+        double compile_ms{};
+        double match_ms{};
+        double mb_per_s{};
+        double matches_per_s{};
+        std::optional<bool> passed{};   // null - the file has no stored matches (or no check)
+        std::string mismatch{};         // the first different line
+        std::string error{};
+        RunStats stats{};               // measurements of every pattern
+        strings results{};
+    };
+
+    /// Run the content with the engine.
+    /// \param file - name of the file (for the report),
+    /// \param content - patterns, source and expected matches,
+    /// \param engine - std, qt or pcre2,
+    /// \param options - settings of the run.
+    Result run(std::string const& file, Content const& content, std::string const& engine, Options const& options);
+
+    /// Load all files and run them with all engines of the options (in parallel).
+    /// \return reports in the order of files and engines.
+    std::vector<Result> run_all(strings const& files, Options const& options);
+}
+
+/*------- template struct for glz:
+-------------------------------------------------------------------*/
+template<>
+struct glz::meta<batch::Result> {
+    using T = batch::Result;
+    static constexpr auto value = object(
+            "file", &T::file,
+            "engine", &T::engine,
+            "patterns", &T::patterns,
+            "lines", &T::lines,
+            "bytes", &T::bytes,
+            "matches", &T::matches,
+            "compile_ms", &T::compile_ms,
+            "match_ms", &T::match_ms,
+            "mb_per_s", &T::mb_per_s,
+            "matches_per_s", &T::matches_per_s,
+            "passed", &T::passed,
+            "mismatch", &T::mismatch,
+            "error", &T::error,
+            "stats", &T::stats,
+            "results", &T::results
+    );
+};
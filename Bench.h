@@ -0,0 +1,176 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include "Counters.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*------- benchmark harness:
+-------------------------------------------------------------------*/
+/// Repeated measurements of one piece of work (engines are compared by these numbers).
+namespace bench {
+    using clock = std::chrono::steady_clock;
+
+    /// Summary of repetitions (times in milliseconds).
+    struct Stats {
+        double min{};
+        double median{};
+        double p99{};
+        double mean{};
+        isize runs{};
+        /// What the last repetition has returned (e.g. number of matches).
+        isize result{};
+        /// Hardware counters of one repetition (the mean, all zeros if not available).
+        perf::Sample counters{};
+    };
+
+    /// Value below which the percent of samples falls (nearest-rank method).
+    inline double percentile(std::vector<double> const& sorted, double const percent) noexcept {
+        if (sorted.empty())
+            return {};
+        auto const rank = isize(std::ceil(percent / 100. * double(sorted.size())));
+        return sorted[std::clamp<isize>(rank - 1, 0, isize(sorted.size()) - 1)];
+    }
+
+    inline Stats summary(std::vector<double> samples, isize const result = {}) noexcept {
+        Stats stats{.runs = isize(samples.size()), .result = result};
+        if (samples.empty())
+            return stats;
+        std::ranges::sort(samples);
+        stats.min = samples.front();
+        stats.median = percentile(samples, 50.);
+        stats.p99 = percentile(samples, 99.);
+        double sum{};
+        for (auto const sample : samples)
+            sum += sample;
+        stats.mean = sum / double(samples.size());
+        return stats;
+    }
+
+    /// How many times the work is done.
+    struct Plan {
+        int warmup{1};
+        int reps{10};
+        /// Repetitions are cut down (to at least one) if they would take longer (ms, 0 - no limit).
+        double budget{};
+    };
+
+    /// Runs the work warmup times (not measured), then measures each repetition.
+    /// \param work - callable returning isize (the result is kept, so the work can't be optimized away),
+    /// \return statistics of the measured repetitions.
+    template<typename Work>
+    Stats measure(Plan const& plan, Work&& work) {
+        auto const elapsed = [](clock::time_point const start) {
+            return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        };
+
+        isize result{};
+        double warm{};
+        for (int i = 0; i < plan.warmup; ++i) {
+            auto const start = clock::now();
+            result = work();
+            warm = elapsed(start);
+        }
+
+        auto reps = std::max(plan.reps, 1);
+        if (plan.budget > 0. and warm > 0.)
+            reps = std::clamp(int(plan.budget / warm), 1, reps);
+
+        auto const& counters = perf::Counters::local();
+        perf::Sample counted;
+        std::vector<double> samples;
+        samples.reserve(reps);
+        for (int i = 0; i < reps; ++i) {
+            auto const before = counters.read();
+            auto const start = clock::now();
+            result = work();
+            samples.push_back(elapsed(start));
+            counted += counters.read() - before;
+            // Without warmup the first sample is the estimate.
+            if (i == 0 and plan.warmup == 0 and plan.budget > 0.)
+                reps = std::clamp(int(plan.budget / std::max(samples[0], 1e-3)), 1, reps);
+        }
+        auto stats = summary(std::move(samples), result);
+        for (auto& value : counted.values)
+            value /= u64(stats.runs);
+        stats.counters = counted;
+        return stats;
+    }
+
+    /// Generated lines of words, numbers, e-mails and 'needle's (the same text for the same size). \n
+    /// There are no '=' and ';' in the text.
+    /// \param size - number of bytes (the last line may be cut).
+    inline std::string text(isize const size) {
+        static constexpr std::string_view words[] = {
+                "the", "of", "and", "regular", "expression", "engine", "matches", "lines", "apple",
+                "banana", "cherry", "durian", "elderberry", "fig", "grape", "a", "in", "benchmark",
+                "pattern", "subject", "backtracking", "automaton", "quick", "brown", "fox", "jumps",
+                "over", "lazy", "dog", "lorem", "ipsum", "dolor", "sit", "amet", "consectetur"};
+        static constexpr std::string_view hosts[] = {"example", "test", "mail", "server"};
+        static constexpr std::string_view domains[] = {"com", "org", "net", "io"};
+
+        // Fixed seed - the same input in every run.
+        std::mt19937 random{2024};
+        auto const pick = [&](auto const& items) {
+            return items[random() % std::size(items)];
+        };
+
+        std::string text;
+        text.reserve(size + 128);
+        while (isize(text.size()) < size) {
+            auto const tokens = 6 + random() % 10;
+            for (auto i = 0u; i < tokens; ++i) {
+                if (i) text += (random() % 12 == 0) ? ", " : " ";
+                auto const kind = random() % 100;
+                if (kind < 78) text += pick(words);
+                else if (kind < 90) text += std::to_string(random() % 1'000'000);
+                else if (kind < 97) {
+                    text += pick(words);
+                    text += '@';
+                    text += pick(hosts);
+                    text += '.';
+                    text += pick(domains);
+                }
+                else text += "needle";
+            }
+            text += '\n';
+        }
+        text.resize(size);
+        return text;
+    }
+
+    /// Throughput in MB/s (decimal megabytes) of the work done in ms.
+    inline double mb_per_s(isize const bytes, double const ms) noexcept {
+        return ms > 0. ? double(bytes) / 1e6 / (ms / 1e3) : 0.;
+    }
+}
@@ -0,0 +1,281 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Benchmark.h"
+#include "RegexStd.h"
+#include "RegexQt.h"
+#ifdef PCRE2_REGEX
+    #include "RegexPcre.h"
+#endif
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+#include <fmt/core.h>
+
+namespace {
+    /// All matches of the engine in the subjects [first, last).
+    template<typename E, typename Subject>
+    isize find_all(E const& rgx,
+                   std::vector<Subject> const& subjects,
+                   std::size_t const first, std::size_t const last,
+                   std::vector<Match>* const matches)
+    {
+        isize n{};
+        for (auto i = first; i < last; ++i)
+            for (auto const& hit : subjects[i].matches(rgx)) {
+                ++n;
+                if (matches)
+                    matches->push_back(subjects[i].span(0, hit.start(0), hit.length(0)));
+            }
+        return n;
+    }
+
+    double elapsed(Run::Clock::time_point const start) noexcept {
+        return std::chrono::duration<double, std::milli>(Run::Clock::now() - start).count();
+    }
+
+#ifdef PCRE2_REGEX
+    /// PCRE2 with the DFA matcher, as an engine for subjects.
+    struct Dfa {
+        using Hit = RegexPcre16::Hit;
+        RegexPcre16 re;
+        mutable std::string error{};
+
+        Dfa(char16_t const* const pattern, std::size_t const n, u32 const options) : re{pattern, n, options} {}
+
+        [[nodiscard]] Generator<Hit> matches(char16_t const* const subject, std::size_t const n) const {
+            return re.dfa_matches(subject, n, &error);
+        }
+    };
+#endif
+}
+
+Benchmark::Engine Benchmark::std_engine(std::shared_ptr<Workload const> workload, type::StdSyntaxOption const options) {
+    auto compile = [workload, options](std::size_t const pattern) -> Scan {
+        // Throws std::regex_error for an invalid pattern.
+        auto rgx = std::make_shared<RegexStd const>(workload->patterns[pattern].toStdString(), options);
+        return [workload, rgx](std::size_t const first, std::size_t const last, std::vector<Match>* const matches) {
+            return find_all(*rgx, workload->utf8, first, last, matches);
+        };
+    };
+    return {"std", std::move(compile)};
+}
+
+Benchmark::Engine Benchmark::qt_engine(std::shared_ptr<Workload const> workload, int const options) {
+    auto compile = [workload, options](std::size_t const pattern) -> Scan {
+        auto rgx = std::make_shared<RegexQt const>(workload->patterns[pattern], QRegularExpression::PatternOptions(options));
+        if (not rgx->valid())
+            throw std::invalid_argument(rgx->error().toStdString());
+        return [workload, rgx](std::size_t const first, std::size_t const last, std::vector<Match>* const matches) {
+            return find_all(*rgx, workload->utf16, first, last, matches);
+        };
+    };
+    return {"qt", std::move(compile)};
+}
+
+#ifdef PCRE2_REGEX
+Benchmark::Engine Benchmark::pcre2_engine(std::shared_ptr<Workload const> workload, u32 const options, Mode const mode) {
+    auto compile = [workload, options, mode](std::size_t const pattern) -> Scan {
+        auto const& text = workload->patterns[pattern];
+        auto const data = reinterpret_cast<char16_t const*>(text.utf16());
+        if (mode == Mode::Dfa) {
+            auto rgx = std::make_shared<Dfa const>(data, std::size_t(text.size()), options);
+            if (not rgx->re.valid())
+                throw std::invalid_argument(rgx->re.error());
+            return [workload, rgx](std::size_t const first, std::size_t const last, std::vector<Match>* const matches) {
+                auto const n = find_all(*rgx, workload->utf16, first, last, matches);
+                // e.g. back references are not supported by the DFA.
+                if (not rgx->error.empty())
+                    throw std::runtime_error(rgx->error);
+                return n;
+            };
+        }
+
+        auto rgx = std::make_shared<RegexPcre16>(data, std::size_t(text.size()), options);
+        if (not rgx->valid())
+            throw std::invalid_argument(rgx->error());
+        if (mode == Mode::Jit and not rgx->jit())
+            throw std::runtime_error("JIT is not available");
+        return [workload, rgx](std::size_t const first, std::size_t const last, std::vector<Match>* const matches) {
+            return find_all(*rgx, workload->utf16, first, last, matches);
+        };
+    };
+    auto name = mode == Mode::Interpreter ? "pcre2 interpreter"
+              : mode == Mode::Jit ? "pcre2 jit"
+              : "pcre2 dfa";
+    return {name, std::move(compile)};
+}
+#endif
+
+Benchmark::Benchmark(std::vector<Engine> engines, bench::Plan const plan, std::shared_ptr<Workload const> workload) :
+    engines_{std::move(engines)},
+    plan_{plan},
+    workload_{std::move(workload)}
+{
+    for (auto const& subject : workload_->utf8)
+        bytes_ += isize(subject.size());
+}
+
+void Benchmark::reset(isize) {
+    results_.assign(engines_.size(), Result{});
+    engine_ = 0;
+    phase_ = Phase::Compile;
+    rep_ = 0;
+    restart();
+    scans_.assign(workload_->patterns.size(), Scan{});
+    found_ = 0;
+}
+
+Run::Status Benchmark::advance(Sink& sink, Clock::time_point const deadline) {
+    // At least one step in every slice - one pattern compiled or one pattern over a chunk of sources.
+    for (auto first = true; engine_ < engines_.size(); first = false) {
+        if (not first and Clock::now() >= deadline)
+            return Status::Slice;
+        try {
+            step();
+        }
+        catch (std::exception const& e) {
+            // e.g. std::regex_error (error_complexity) - the engine is out.
+            results_[engine_].error = e.what();
+            next_engine();
+        }
+    }
+    report(sink);
+    return Status::Done;
+}
+
+void Benchmark::step() {
+    auto& result = results_[engine_];
+    auto const measured = rep_ >= plan_.warmup;
+    auto const reps = plan_.warmup + std::max(plan_.reps, 1);
+    auto const patterns = scans_.size();
+    auto const sources = workload_->utf8.size();
+
+    if (phase_ == Phase::Compile) {
+        auto const start = Clock::now();
+        scans_[pattern_] = engines_[engine_].compile(pattern_);
+        time_ += elapsed(start);
+        if (++pattern_ < patterns)
+            return;
+        if (measured)
+            result.compile.push_back(time_);
+        restart();
+        if (++rep_ == reps) {
+            phase_ = Phase::Verify;
+            rep_ = 0;
+        }
+        return;
+    }
+
+    // Verify and Match - the current pattern over the next chunk of sources.
+    auto const last = std::min(source_ + Chunk, sources);
+    auto const start = Clock::now();
+    count_ += scans_[pattern_](source_, last, phase_ == Phase::Verify ? &result.found : nullptr);
+    time_ += elapsed(start);
+    if ((source_ = last) < sources)
+        return;
+    source_ = 0;
+    if (++pattern_ < patterns)
+        return;
+
+    if (phase_ == Phase::Verify) {
+        result.matches = count_;
+        std::ranges::sort(result.found, {}, [](Match const& m) {
+            return std::tuple{m.line, m.pos, m.length};
+        });
+        phase_ = Phase::Match;
+        restart();
+        return;
+    }
+    if (measured)
+        result.match.push_back(time_);
+    found_ = count_;
+    restart();
+    if (++rep_ == reps)
+        next_engine();
+}
+
+void Benchmark::restart() noexcept {
+    pattern_ = 0;
+    source_ = 0;
+    time_ = 0.;
+    count_ = 0;
+}
+
+void Benchmark::next_engine() noexcept {
+    ++engine_;
+    phase_ = Phase::Compile;
+    rep_ = 0;
+    restart();
+    std::ranges::fill(scans_, Scan{});
+}
+
+void Benchmark::report(Sink& sink) const {
+    auto const same = [](std::vector<Match> const& a, std::vector<Match> const& b) {
+        return std::ranges::equal(a, b, [](Match const& x, Match const& y) {
+            return x.line == y.line and x.pos == y.pos and x.length == y.length;
+        });
+    };
+
+    sink.line(fmt::format("=== benchmark: {} runs after {} warmup, {} patterns, {} lines, {:.1f} KB ===",
+                          std::max(plan_.reps, 1), plan_.warmup, workload_->patterns.size(),
+                          workload_->utf8.size(), double(bytes_) / 1024.));
+    sink.line(fmt::format("{:<18} {:>27} {:>27} {:>9} {:>9}  {}",
+                          "engine", "compile ms min/median/p99", "match ms min/median/p99", "MB/s", "matches", "same"));
+
+    // The first engine that works is the reference of matches.
+    auto const reference = std::ranges::find_if(results_, [](Result const& r) { return r.error.empty(); });
+    strings differ;
+    for (std::size_t i = 0; i < engines_.size(); ++i) {
+        auto const& name = engines_[i].name;
+        auto const& result = results_[i];
+        if (not result.error.empty()) {
+            sink.line(fmt::format("{:<18} ERROR: {}", name, result.error));
+            continue;
+        }
+        auto const compile = bench::summary(result.compile);
+        auto const match = bench::summary(result.match);
+        auto const identical = same(result.found, reference->found);
+        if (not identical)
+            differ.push_back(name);
+        sink.line(fmt::format("{:<18} {:>8.3f} {:>8.3f} {:>9.3f} {:>8.3f} {:>8.3f} {:>9.3f} {:>9.1f} {:>9}  {}",
+                              name, compile.min, compile.median, compile.p99,
+                              match.min, match.median, match.p99,
+                              bench::mb_per_s(bytes_, match.median), result.matches,
+                              identical ? "yes" : "NO"));
+    }
+    if (reference == results_.end())
+        sink.line("=== no engine could run the patterns ===");
+    else if (differ.empty())
+        sink.line("=== all engines found the same matches ===");
+    else {
+        std::string names;
+        for (auto const& name : differ)
+            names += (names.empty() ? "" : ", ") + name;
+        sink.line(fmt::format("=== matches differ from '{}': {} ===",
+                              engines_[std::size_t(reference - results_.begin())].name, names));
+    }
+}
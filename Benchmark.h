@@ -0,0 +1,135 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include "Search.h"
+#include "Subject.h"
+#include "Bench.h"
+#include "model/Match.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// Repeated runs of the patterns with the sources on several engines. \n
+/// Compilation and matching are measured apart (min, median, p99 of repetitions),
+/// engines are checked for finding the same matches. A step compiles one pattern or runs one
+/// pattern over a chunk of sources, so the benchmark runs in time slices on the scheduler
+/// like any other run (a repetition is the sum of its steps); the report goes to the sink at the end.
+class Benchmark : public Run {
+public:
+    /// Finds all matches of one pattern in the sources [first, last).
+    /// Positions of whole matches go to the vector (if not null).
+    using Scan = std::function<isize(std::size_t first, std::size_t last, std::vector<Match>*)>;
+    /// Compiles the pattern with the index, the returned scan uses it.
+    /// \throws std::exception if a pattern can't be compiled (or the engine does not support it).
+    using Compile = std::function<Scan(std::size_t pattern)>;
+
+    struct Engine {
+        std::string name;
+        Compile compile;
+    };
+
+    /// Patterns and sources in the forms engines work on (shared by all engines).
+    struct Workload {
+        qstrings patterns{};
+        std::vector<Utf8Subject> utf8{};
+        std::vector<Utf16Subject> utf16{};
+    };
+
+    /// std::regex on UTF-8 sources.
+    static Engine std_engine(std::shared_ptr<Workload const> workload, type::StdSyntaxOption options);
+    /// QRegularExpression on QString sources.
+    static Engine qt_engine(std::shared_ptr<Workload const> workload, int options);
+#ifdef PCRE2_REGEX
+    enum class Mode { Interpreter, Jit, Dfa };
+    /// PCRE2 (16-bit) on QString sources, with the selected matcher.
+    static Engine pcre2_engine(std::shared_ptr<Workload const> workload, u32 options, Mode mode);
+#endif
+
+    /// \param engines - engines to compare (the first one that works is the reference of matches),
+    /// \param plan - warmup and repetitions,
+    /// \param workload - the measured patterns and sources (for throughput and the report).
+    Benchmark(std::vector<Engine> engines, bench::Plan plan, std::shared_ptr<Workload const> workload);
+
+    void reset(isize limit) override;
+    void next_page() override {}
+    Status advance(Sink& sink, Clock::time_point deadline) override;
+    /// Benchmarks are not sampled (nothing is sent).
+    void sample(Sink&, isize) override {}
+    [[nodiscard]] strings groups(int) const override {
+        return {};
+    }
+    [[nodiscard]] isize found() const noexcept override {
+        return found_;
+    }
+
+private:
+    /// What the next step does with the current engine.
+    enum class Phase {
+        Compile,    // compile (warmup and repetitions)
+        Verify,     // find all matches with positions (not measured)
+        Match,      // find all matches (warmup and repetitions)
+    };
+    /// Measurements of one engine.
+    struct Result {
+        std::vector<double> compile{};
+        std::vector<double> match{};
+        isize matches{};
+        std::vector<Match> found{};
+        std::string error{};
+    };
+
+    /// Sources scanned by one pattern in one step.
+    static constexpr std::size_t Chunk = 256;
+
+    /// One step with the current engine - one pattern compiled or one pattern over a chunk of sources.
+    void step();
+    /// The next repetition (or phase) starts from the first pattern.
+    void restart() noexcept;
+    /// The current engine is done (or failed), the next one starts.
+    void next_engine() noexcept;
+    /// Table of results and the comparison of matches.
+    void report(Sink& sink) const;
+
+    std::vector<Engine> const engines_;
+    bench::Plan const plan_;
+    std::shared_ptr<Workload const> const workload_;
+    isize bytes_{};
+    std::vector<Result> results_{};
+    std::size_t engine_{};
+    Phase phase_{Phase::Compile};
+    int rep_{};
+    std::size_t pattern_{};
+    std::size_t source_{};
+    double time_{};
+    isize count_{};
+    std::vector<Scan> scans_{};
+    isize found_{};
+};
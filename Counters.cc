@@ -0,0 +1,127 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Counters.h"
+#ifdef __linux__
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace perf {
+#ifdef __linux__
+    namespace {
+        struct Kind {
+            u32 type;
+            u64 config;
+        };
+        constexpr std::array<Kind, Count> Kinds{{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+                                 | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                 | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+        }};
+
+        int open(Kind const kind, int const group) noexcept {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = kind.type;
+            attr.config = kind.config;
+            attr.disabled = group == -1;    // the group starts when all counters are in
+            // User space only - allowed with perf_event_paranoid 2 (the default).
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            // The calling thread on any CPU.
+            return int(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+        }
+    }
+
+    Counters::Counters() noexcept {
+        fds_.fill(-1);
+        for (int i = 0; i < Count; ++i) {
+            // Not every CPU (or VM) has every counter - the others are still counted.
+            if (auto const fd = open(Kinds[i], leader_); fd >= 0) {
+                if (leader_ == -1)
+                    leader_ = fd;
+                fds_[i] = fd;
+                order_[i] = opened_++;
+            }
+        }
+        if (leader_ not_eq -1)
+            ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    Counters::~Counters() {
+        for (auto const fd : fds_)
+            if (fd >= 0)
+                close(fd);
+    }
+
+    bool Counters::available() const noexcept {
+        return fds_[Cycles] >= 0 and fds_[Instructions] >= 0;
+    }
+
+    Sample Counters::read() const noexcept {
+        Sample sample;
+        if (leader_ == -1)
+            return sample;
+        // nr, time enabled, time running, values (in the order of opening).
+        std::array<u64, 3 + Count> buffer{};
+        if (::read(leader_, buffer.data(), sizeof(buffer)) < ssize_t(3 * sizeof(u64)))
+            return sample;
+        auto const enabled = buffer[1];
+        auto const running = buffer[2];
+        // More groups than counters of the CPU - the kernel multiplexes them, counts are scaled.
+        auto const scale = running and running < enabled ? double(enabled) / double(running) : 1.0;
+        for (int i = 0; i < Count; ++i)
+            if (fds_[i] >= 0)
+                sample.values[i] = u64(double(buffer[3 + order_[i]]) * scale);
+        return sample;
+    }
+#else
+    Counters::Counters() noexcept {
+        fds_.fill(-1);
+    }
+    Counters::~Counters() = default;
+    bool Counters::available() const noexcept {
+        return false;
+    }
+    Sample Counters::read() const noexcept {
+        return {};
+    }
+#endif
+
+    Counters& Counters::local() noexcept {
+        thread_local Counters counters;
+        return counters;
+    }
+}
@@ -0,0 +1,91 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include <array>
+
+/*------- hardware counters:
+-------------------------------------------------------------------*/
+/// Hardware performance counters of the calling thread (Linux perf_event_open). \n
+/// Counters are opened once per thread, as one group (one system call reads all of them).
+/// Where they can't be opened (other systems, perf_event_paranoid, containers) nothing is counted
+/// and runs are measured only by wall time.
+namespace perf {
+    enum Event {
+        Cycles,
+        Instructions,
+        BranchMisses,
+        L1Misses,       // L1 data cache, reads
+        LlcMisses,      // last level cache
+        PageFaults,
+        Count
+    };
+
+    /// Values of counters (counters that can't be opened stay 0).
+    struct Sample {
+        std::array<u64, Count> values{};
+
+        [[nodiscard]] u64 operator[](Event const event) const noexcept {
+            return values[event];
+        }
+        /// Counts between two samples (counters scaled for multiplexing may go back a bit).
+        Sample operator-(Sample const& other) const noexcept {
+            Sample delta;
+            for (int i = 0; i < Count; ++i)
+                delta.values[i] = values[i] > other.values[i] ? values[i] - other.values[i] : 0;
+            return delta;
+        }
+        Sample& operator+=(Sample const& other) noexcept {
+            for (int i = 0; i < Count; ++i)
+                values[i] += other.values[i];
+            return *this;
+        }
+    };
+
+    class Counters {
+    public:
+        /// Counters of the calling thread (opened on the first call, closed when the thread ends).
+        static Counters& local() noexcept;
+
+        ~Counters();
+        Counters(Counters const&) = delete;
+        Counters& operator=(Counters const&) = delete;
+
+        /// Checks if the thread counts at least cycles and instructions.
+        [[nodiscard]] bool available() const noexcept;
+        /// Current values (counted since the counters were opened).
+        [[nodiscard]] Sample read() const noexcept;
+
+    private:
+        Counters() noexcept;
+
+        int leader_{-1};                    // fd of the group (-1 - not available)
+        std::array<int, Count> fds_{};      // fds of counters (-1 - not opened)
+        std::array<int, Count> order_{};    // index of the value of the counter in the group read
+        int opened_{};
+    };
+}
@@ -27,9 +27,24 @@
 #include "Editor.h"
 #include "Highlighter.h"
 #include "EventController.h"
+#include "Stage.h"
+#include <QToolTip>
+#include <QHelpEvent>
+#include <QMouseEvent>
+#include <QTextBlock>
+#include <QTextBlockUserData>
+#include <algorithm>
 #include <fmt/core.h>
 using namespace std;
 
+/// Id of the match shown in the row (block) of the matches-view.
+struct RowData : QTextBlockUserData {
+    int id;
+    bool expanded{};
+
+    explicit RowData(int const id) : id{id} {}
+};
+
 Editor::Editor(Highlighting const highlighting, QWidget* const parent) :
         QTextEdit(parent)
 {
@@ -54,8 +69,6 @@ Editor::Editor(Highlighting const highlighting, QWidget* const parent) :
     if (highlighting == Highlighting::Yes) {
         highlighter_ = new Highlighter(document());
         connect(this, &QTextEdit::textChanged, this, &Editor::text_changed);
-        EventController::instance().append(this, event::Match);
-
     }
 }
 
@@ -70,15 +83,19 @@ void Editor::customEvent(QEvent *event) {
     switch (int(e->type())) {
         case event::AppendLine:
             if (isReadOnly()) {
-                if (e->data().size() == 1) {
-                    auto text = e->data()[0].toString();
-                    append(text);
-                }
+                stage::Scope const scope{stage::Append};
+                append(qstr::fromStdString(e->text()));
+                // Row with id - details can be fetched later.
+                if (e->ref() >= 0)
+                    document()->lastBlock().setUserData(new RowData(e->ref()));
             }
             break;
         case event::Match: {
-            auto str = e->data()[0].toString().toStdString();
-            auto data = glz::read_json<vector<Match>>(str);
+            stage::Scope const scope{stage::Highlight};
+            auto data = [e] {
+                stage::Scope const parse{stage::Parse};
+                return glz::read_json<vector<Match>>(e->text());
+            }();
             if (not data.has_value()) {
                 fmt::print(stderr, "ERROR: invalid JSON string\n");
                 return;
@@ -97,3 +114,85 @@ void Editor::set(vector<string> const& data) noexcept {
         plain_text = plain_text.append(qstr::fromStdString(text)).append('\n');
     insertPlainText(plain_text);
 }
+
+void Editor::append_text(qstr const& text) noexcept {
+    QTextCursor cursor(document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.insertText(text);
+}
+
+void Editor::show_line(int const nr) noexcept {
+    auto const block = document()->findBlockByNumber(nr);
+    if (not block.isValid())
+        return;
+    QTextCursor cursor(block);
+    cursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor);
+    setTextCursor(cursor);
+    ensureCursorVisible();
+    setFocus();
+}
+
+void Editor::heatmap(std::vector<Heat> const& spans) noexcept {
+    // Extra selections are drawn over the text, the document and its highlighting stay as they are.
+    QList<ExtraSelection> selections;
+    for (auto const& [nr, position, length, level] : spans) {
+        auto const block = document()->findBlockByNumber(nr);
+        if (not block.isValid() or position + length >= block.length())
+            continue;
+        QTextCursor cursor(block);
+        cursor.setPosition(block.position() + int(position));
+        cursor.setPosition(block.position() + int(position + length), QTextCursor::KeepAnchor);
+        // From dark blue (cold) to red (hot).
+        auto const mix = [level](int const cold, int const hot) {
+            return int(cold + (hot - cold) * std::clamp(level, 0.0, 1.0));
+        };
+        ExtraSelection selection;
+        selection.cursor = cursor;
+        selection.format.setBackground(QColor(mix(0x28, 0xd0), mix(0x30, 0x30), mix(0x60, 0x20)));
+        selections.push_back(selection);
+    }
+    setExtraSelections(selections);
+}
+
+strings Editor::details(QTextBlock const& block) const {
+    if (not details_)
+        return {};
+    if (auto const row = dynamic_cast<RowData*>(block.userData()); row)
+        return details_(row->id);
+    return {};
+}
+
+bool Editor::viewportEvent(QEvent* const event) {
+    if (event->type() == QEvent::ToolTip) {
+        auto const help = static_cast<QHelpEvent*>(event);
+        auto const block = cursorForPosition(help->pos()).block();
+        if (auto const lines = details(block); not lines.empty()) {
+            QStringList text;
+            for (auto const& line : lines)
+                text.push_back(qstr::fromStdString(line));
+            QToolTip::showText(help->globalPos(), text.join('\n'), this);
+        }
+        else
+            QToolTip::hideText();
+        return true;
+    }
+    return QTextEdit::viewportEvent(event);
+}
+
+void Editor::mouseDoubleClickEvent(QMouseEvent* const event) {
+    auto const block = cursorForPosition(event->pos()).block();
+    auto const row = dynamic_cast<RowData*>(block.userData());
+    if (not row or row->expanded) {
+        QTextEdit::mouseDoubleClickEvent(event);
+        return;
+    }
+    row->expanded = true;
+    // Groups are inserted (indented) after the row.
+    QTextCursor cursor(block);
+    cursor.movePosition(QTextCursor::EndOfBlock);
+    for (auto const& line : details(block)) {
+        cursor.insertBlock();
+        cursor.insertText(qstr::fromStdString("    " + line));
+    }
+    event->accept();
+}
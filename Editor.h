@@ -27,12 +27,15 @@
 -------------------------------------------------------------------*/
 #include "Types.h"
 #include <QTextEdit>
+#include <functional>
 #include <vector>
 #include <string>
 
 /*------- forward declaration:
 -------------------------------------------------------------------*/
 class QEvent;
+class QMouseEvent;
+class QTextBlock;
 class Highlighter;
 
 /*------- class:
@@ -40,6 +43,9 @@ class Highlighter;
 class Editor : public QTextEdit {
     Q_OBJECT
 public:
+    /// Provider of lines with details of the row (groups of the match by its id).
+    using Details = std::function<strings(int)>;
+
     explicit Editor(Highlighting = Highlighting::No, QWidget* parent = nullptr);
     ~Editor() override = default;
 
@@ -50,9 +56,43 @@ public:
     }
 
     void set(std::vector<std::string> const& data) noexcept;
+
+    /// Append the text at the end of the document (a big text comes in chunks).
+    void append_text(qstr const& text) noexcept;
+
+    /// Set provider of details for rows with id (nothing if empty).
+    void set_details(Details details) noexcept {
+        details_ = std::move(details);
+    }
+
+    /// Select the line and scroll to it.
+    /// \param nr - number of the line (from 0).
+    void show_line(int nr) noexcept;
+
+    /// Heat of the span of the text.
+    struct Heat {
+        int block;          // number of the line
+        isize position;     // in the line
+        isize length;
+        double level;       // 0 - cold ... 1 - the hottest
+    };
+    /// Backgrounds of spans from cold to hot (the text is not changed).
+    /// \param spans - the heatmap (empty - the heatmap is removed).
+    void heatmap(std::vector<Heat> const& spans) noexcept;
+protected:
+    /// Tooltip with details of the row under the mouse.
+    bool viewportEvent(QEvent* event) override;
+
+    /// Double click expands the row - details are inserted below it.
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+
 private slots:
     void text_changed() noexcept;
 
 private:
+    /// Details of the row in the block (empty if the row has no id).
+    [[nodiscard]] strings details(QTextBlock const& block) const;
+
     Highlighter* highlighter_{};
+    Details details_{};
 };
@@ -27,11 +27,24 @@
 -------------------------------------------------------------------*/
 #include <QEvent>
 #include "Types.h"
+#include <atomic>
+#include <string>
+#include <string_view>
 
 /*------- class:
 -------------------------------------------------------------------*/
+/// Event with arguments. \n
+/// Hot events (lines and matches from workers) carry a typed payload - text and reference,
+/// without boxing in QVariant. Events sent by EventController are pooled and reused.
 class Event : public QEvent {
+    friend class EventController;
+    friend class EventPool;
+
     qvec<qvar> data_;
+    std::string text_{};
+    int ref_{-1};
+    QObject* receiver_{};                   // set while the event waits in the queue
+    std::atomic<Event*> next_{};            // link of the dispatch queue
 public:
     template<typename... T>
     explicit Event(int const id, T... args) : QEvent(static_cast<QEvent::Type>(id)) {
@@ -43,6 +56,35 @@ public:
     qvec<qvar> const& data() const& {
         return data_;
     }
+    /// Typed payload (UTF-8 text) of a hot event.
+    [[nodiscard]] std::string const& text() const noexcept {
+        return text_;
+    }
+    /// Reference carried with the text (-1 if none).
+    [[nodiscard]] int ref() const noexcept {
+        return ref_;
+    }
+
+private:
+    /// Empty slot of the pool.
+    Event() : QEvent(QEvent::None) {}
+
+    /// Reuse the event for a new id and arguments (buffers keep their capacity).
+    template<typename... T>
+    void assign(int const id, T... args) {
+        t = static_cast<decltype(t)>(id);
+        setAccepted(true);
+        data_.clear();
+        (..., data_.push_back(args));
+        text_.clear();
+        ref_ = -1;
+    }
+    /// Reuse the event for a hot id with the typed payload.
+    void assign_text(int const id, std::string_view const text, int const ref) {
+        assign(id);
+        text_.assign(text);
+        ref_ = ref;
+    }
 };
 
 
@@ -55,6 +97,18 @@ namespace event {
         SaveFile,
         SaveAsFile,
         RunRequest,
+        MoreRequest,
+        SampleRequest,
+        RunSlice,
+        RunAllRequest,
+        ExportRequest,
+        ReplaceRequest,
+        ReplaceTabRequest,
+        BenchmarkRequest,
+        ProfileRequest,
+        TraceRequest,
+        RunDone,
+        Dispatch,
         BreakRequest,
         AppendLine,
         ClearAll,
@@ -25,24 +25,155 @@
 /*------- include files:
 -------------------------------------------------------------------*/
 #include "EventController.h"
+#include "Stage.h"
+#include <QCoreApplication>
+#include <algorithm>
 #include <mutex>
 
-bool EventController::append(QObject* subscriber, i32 event_id) noexcept {
-    std::lock_guard<std::mutex> lock(mutex_);
+EventController::EventController() :
+    QObject()
+{
+    publish(std::make_unique<Table>());
+    // Events are delivered on the GUI thread, whichever thread asks for the instance first.
+    if (auto const app = QCoreApplication::instance(); app and thread() not_eq app->thread())
+        moveToThread(app->thread());
+}
+
+EventController::~EventController() {
+    for (auto const event : backlog_)
+        recycle(event);
+    while (auto const event = pop())
+        recycle(event);
+}
 
-    if (exists(subscriber, event_id))
+bool EventController::append(QObject* const subscriber, i32 const event_id) noexcept {
+    auto const index = isize(event_id - QEvent::User);
+    if (index < 0)
         return {};
+    {
+        std::lock_guard<std::mutex> lock(writer_);
+        auto const current = table_.load(std::memory_order_acquire);
+        if (index < isize(current->size()) and std::ranges::find((*current)[index], subscriber) not_eq (*current)[index].end())
+            return {};
 
-    data_[event_id] << subscriber;
+        auto table = std::make_unique<Table>(*current);
+        if (index >= isize(table->size()))
+            table->resize(index + 1);
+        (*table)[index].push_back(subscriber);
+        publish(std::move(table));
+    }
+    track(subscriber);
     return true;
 }
 
-void EventController::remove(QObject* subscriber) noexcept {
-    std::lock_guard<std::mutex> lock(mutex_);
+void EventController::remove(QObject* const subscriber) noexcept {
+    {
+        std::lock_guard<std::mutex> lock(writer_);
+        auto table = std::make_unique<Table>(*table_.load(std::memory_order_acquire));
+        isize erased{};
+        for (auto& subscribers : *table)
+            erased += isize(std::erase(subscribers, subscriber));
+        // Most removed objects are only tracked receivers (not subscribers).
+        if (erased)
+            publish(std::move(table));
+    }
+    tracked_.remove(subscriber);
+
+    // Events already queued for the subscriber are never delivered.
+    while (auto const event = pop())
+        backlog_.push_back(event);
+    std::erase_if(backlog_, [this, subscriber](Event* const event) {
+        if (event->receiver_ not_eq subscriber)
+            return false;
+        recycle(event);
+        return true;
+    });
+}
+
+void EventController::publish(std::unique_ptr<Table> table) noexcept {
+    // Readers may still use the old table - it is kept (until shutdown).
+    table_.store(table.get(), std::memory_order_release);
+    tables_.push_back(std::move(table));
+}
+
+void EventController::track(QObject* const receiver) noexcept {
+    if (tracked_.contains(receiver))
+        return;
+    tracked_.insert(receiver);
+    connect(receiver, &QObject::destroyed, this, &EventController::remove, Qt::DirectConnection);
+}
+
+void EventController::customEvent(QEvent* const event) {
+    if (int(event->type()) == event::Dispatch)
+        dispatch();
+}
+
+void EventController::push(QObject* const receiver, Event* const event) noexcept {
+    event->receiver_ = receiver;
+    link(event);
+    wake();
+}
+
+void EventController::link(Event* const event) noexcept {
+    event->next_.store(nullptr, std::memory_order_relaxed);
+    // One exchange - producers never wait for each other.
+    auto const prev = head_.exchange(event, std::memory_order_acq_rel);
+    prev->next_.store(event, std::memory_order_release);
+}
+
+Event* EventController::pop() noexcept {
+    auto tail = tail_;
+    auto next = tail->next_.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+        if (not next)
+            return nullptr;
+        tail_ = tail = next;
+        next = next->next_.load(std::memory_order_acquire);
+    }
+    if (next) {
+        tail_ = next;
+        return tail;
+    }
+    // The producer has swapped the head but has not linked its event yet.
+    if (tail not_eq head_.load(std::memory_order_acquire))
+        return nullptr;
+    // The last event - the stub goes behind it, so the queue is never empty.
+    link(&stub_);
+    next = tail->next_.load(std::memory_order_acquire);
+    if (next) {
+        tail_ = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+bool EventController::empty() const noexcept {
+    return tail_ == &stub_ and head_.load(std::memory_order_acquire) == &stub_;
+}
+
+void EventController::dispatch() noexcept {
+    stage::Scope const scope{stage::Dispatch};
+    scheduled_.store(false);
+    for (;;) {
+        Event* event{};
+        if (not backlog_.empty()) {
+            event = backlog_.front();
+            backlog_.pop_front();
+        }
+        else if (event = pop(); not event)
+            break;
+
+        // A handler may destroy objects, they are forgotten (remove) immediately.
+        if (tracked_.contains(event->receiver_))
+            QCoreApplication::sendEvent(event->receiver_, event);
+        recycle(event);
+    }
+    // An event whose push was not complete - its sender might have found the flag still set.
+    if (not empty())
+        wake();
+}
 
-    if (data_.isEmpty()) return;
-    qlist<i32> const ids = data_.keys();
-    for (auto it = ids.cbegin(); it < ids.cend(); ++it)
-        data_[*it].remove(subscriber);
-    data_.squeeze();
+void EventController::wake() noexcept {
+    if (not scheduled_.exchange(true))
+        QCoreApplication::postEvent(this, new QEvent(static_cast<QEvent::Type>(event::Dispatch)));
 }
@@ -26,19 +26,39 @@
 /*------- include files:
 -------------------------------------------------------------------*/
 #include "Event.h"
+#include "EventPool.h"
 #include "Types.h"
 #include <QSet>
-#include <QHash>
 #include <QObject>
 #include <QApplication>
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <string_view>
+#include <vector>
 
 /*------- class declaration:
 -------------------------------------------------------------------*/
+/// Dispatcher of events between objects and threads. \n
+/// Senders never block: the subscriber table is immutable and replaced as a whole
+/// by a registration (copy-on-write, read with one atomic load of the pointer - old tables
+/// are kept until shutdown, registrations are rare), events go to a lock-free MPSC queue
+/// and are delivered in bursts on the GUI thread. Events come from a pool and are reused.
 class EventController : public QObject {
-    using EventRegister = qhash<i32, qset<QObject*>>;
-    std::mutex mutex_;
-    EventRegister data_;
+    /// Subscribers of events indexed by (event id - QEvent::User).
+    using Table = std::vector<std::vector<QObject*>>;
+    std::atomic<Table const*> table_;       // the current table (lock-free, unlike atomic<shared_ptr>)
+    std::vector<std::unique_ptr<Table const>> tables_{};    // all published tables (readers may still use old ones)
+    std::mutex writer_;                     // serializes registrations only
+    EventPool pool_{};
+    // The MPSC queue (Vyukov) - any thread pushes, only the GUI thread pops.
+    Event stub_{};
+    std::atomic<Event*> head_{&stub_};
+    Event* tail_{&stub_};
+    std::atomic<bool> scheduled_{};         // event::Dispatch is already posted
+    std::deque<Event*> backlog_{};          // popped but not delivered yet (GUI thread)
+    qset<QObject*> tracked_{};              // living receivers (GUI thread)
 public:
     static EventController& instance() noexcept {
         static EventController ec;
@@ -49,7 +69,7 @@ public:
     EventController(EventController&&) = delete;
     EventController& operator=(EventController const&) = delete;
     EventController& operator=(EventController&&) = delete;
-    ~EventController() override = default;
+    ~EventController() override;
 
     /// Registering a subscriber for an event.
     /// \param subscriber subscriber object for registration
@@ -57,35 +77,81 @@ public:
     /// \return True if registration was successful, False otherwise.
     bool append(QObject* subscriber, i32 event_id) noexcept;
 
-    /// A subscriber object that opts out of receiving ALL events.
+    /// A subscriber object that opts out of receiving ALL events. \n
+    /// Events still waiting for the subscriber are dropped. Must be called on the GUI thread
+    /// (it is called automatically when the subscriber is destroyed).
     /// \param subscriber unsubscriber object
     void remove(QObject* subscriber) noexcept;
 
+    /// Receiving events sent directly (post) - events waiting for the object
+    /// are dropped when it is destroyed. Must be called on the GUI thread.
+    /// \param receiver the object.
+    void track(QObject* receiver) noexcept;
+
     /// Sending the event with arguments to all subscribers.
     /// \param event_id event
     /// \param args arguments to send in the event.
     template<typename... T>
     void send_event(i32 event_id, T... args) noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
-
-        if (data_.capacity() not_eq data_.size())
-            data_.squeeze();
-        if (not data_.contains(event_id))
+        auto const table = table_.load(std::memory_order_acquire);
+        auto const index = event_id - QEvent::User;
+        if (index < 0 or index >= isize(table->size()))
             return;
-        auto const& subscribers = data_[event_id];
-        for (auto const receiver : subscribers)
-            QApplication::postEvent(receiver, new Event(event_id, args...));
+        for (auto const receiver : (*table)[index]) {
+            auto const event = make();
+            event->assign(event_id, args...);
+            push(receiver, event);
+        }
+    }
+
+    /// Sending the event with arguments to one receiver (see track).
+    template<typename... T>
+    void post(QObject* const receiver, i32 const event_id, T... args) noexcept {
+        auto const event = make();
+        event->assign(event_id, args...);
+        push(receiver, event);
     }
 
+    /// Sending the hot event with the typed payload (no QVariant boxing) to one receiver.
+    void post_text(QObject* const receiver, i32 const event_id, std::string_view const text, int const ref = -1) noexcept {
+        auto const event = make();
+        event->assign_text(event_id, text, ref);
+        push(receiver, event);
+    }
+
+protected:
+    void customEvent(QEvent* event) override;
+
 private:
     /// EventsController is Singleton, constructor is private.
-    EventController() : QObject() {}
+    EventController();
 
-    /// Checks whether the subscriber is already registered for the event.
-    /// \param subscriber a subscriber whose presence is checked,
-    /// \param event_idthe event the subscriber is interested in
-    /// \return True if the subscriber is registered for the indicated event, False otherwise.
-    bool exists(QObject* subscriber, i32 event_id) noexcept {
-        return data_.contains(event_id) and data_.value(event_id).contains(subscriber);
+    /// An event from the pool (or from the heap if the pool is exhausted).
+    Event* make() noexcept {
+        if (auto const event = pool_.acquire(); event)
+            return event;
+        return new Event;
+    }
+    /// The event goes back to the pool (or is deleted).
+    void recycle(Event* const event) noexcept {
+        if (not pool_.release(event))
+            delete event;
     }
+
+    /// Make the table current (under writer_).
+    void publish(std::unique_ptr<Table> table) noexcept;
+
+    /// Queue the event for the receiver, wake the GUI thread if it sleeps.
+    void push(QObject* receiver, Event* event) noexcept;
+    /// Link the event at the head of the queue (any thread).
+    void link(Event* event) noexcept;
+    /// Take the oldest event from the queue (GUI thread).
+    /// \return the event or nullptr if there is none (or the next one is being pushed).
+    Event* pop() noexcept;
+    /// Checks whether nothing waits in the queue (GUI thread).
+    [[nodiscard]] bool empty() const noexcept;
+    /// Deliver all queued events (GUI thread).
+    void dispatch() noexcept;
+    /// Ask the GUI thread for dispatch (once per burst).
+    void wake() noexcept;
 };
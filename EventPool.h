@@ -0,0 +1,89 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Event.h"
+#include "Types.h"
+#include <atomic>
+#include <memory>
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// Lock-free pool of events (Treiber stack of slot indexes). \n
+/// Any thread may acquire an event, any thread may release it.
+/// The head carries a tag changed by every operation, so a slot
+/// popped and pushed back meanwhile (ABA) is detected.
+class EventPool {
+    static constexpr u32 Capacity = 1024;
+    static constexpr u32 Nil = Capacity;
+
+    std::unique_ptr<Event[]> slots_;
+    std::unique_ptr<std::atomic<u32>[]> next_;
+    std::atomic<u64> head_{};               // tag << 32 | index of the first free slot
+public:
+    EventPool() :
+        slots_{new Event[Capacity]},
+        next_{new std::atomic<u32>[Capacity]}
+    {
+        for (u32 i = 0; i < Capacity; ++i)
+            next_[i].store(i + 1, std::memory_order_relaxed);
+        head_.store(0, std::memory_order_release);
+    }
+    EventPool(EventPool const&) = delete;
+    EventPool& operator=(EventPool const&) = delete;
+
+    /// Take a free event from the pool.
+    /// \return the event or nullptr if all slots are in use.
+    [[nodiscard]] Event* acquire() noexcept {
+        auto head = head_.load(std::memory_order_acquire);
+        for (;;) {
+            auto const index = u32(head);
+            if (index == Nil)
+                return nullptr;
+            auto const next = next_[index].load(std::memory_order_relaxed);
+            if (head_.compare_exchange_weak(head, tagged(head, next), std::memory_order_acq_rel, std::memory_order_acquire))
+                return &slots_[index];
+        }
+    }
+
+    /// Give the event back.
+    /// \return false if the event does not come from the pool (the caller deletes it).
+    bool release(Event* const event) noexcept {
+        if (event < slots_.get() or event >= slots_.get() + Capacity)
+            return false;
+        auto const index = u32(event - slots_.get());
+        auto head = head_.load(std::memory_order_relaxed);
+        do {
+            next_[index].store(u32(head), std::memory_order_relaxed);
+        } while (not head_.compare_exchange_weak(head, tagged(head, index), std::memory_order_release, std::memory_order_relaxed));
+        return true;
+    }
+
+private:
+    static u64 tagged(u64 const head, u32 const index) noexcept {
+        return ((head >> 32) + 1) << 32 | index;
+    }
+};
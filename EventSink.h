@@ -0,0 +1,96 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Sink.h"
+#include "Event.h"
+#include "EventController.h"
+#include "Stage.h"
+#include <glaze/glaze.hpp>
+#include <atomic>
+#include <vector>
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// Sink for the GUI - lines go to the matches-view as events,
+/// matches are collected and highlighted at once (flush). \n
+/// Matches of next pages are added to the collected ones.
+/// Events are posted to editors of one window (other tabs are not disturbed),
+/// posting is thread safe and does not block - the sink may be used by a worker thread.
+class EventSink : public Sink {
+    QObject* lines_{};
+    QObject* highlights_target_{};
+    std::vector<Match> highlights_{};
+    std::atomic<bool> const* cancelled_{};     // nothing is posted when set (the task was cancelled)
+public:
+    EventSink() = default;
+    /// \param lines - the editor that shows lines (matches-view),
+    /// \param highlights - the editor that highlights matches (source-editor).
+    EventSink(QObject* const lines, QObject* const highlights) :
+        lines_{lines},
+        highlights_target_{highlights}
+    {
+        EventController::instance().track(lines_);
+        EventController::instance().track(highlights_target_);
+    }
+
+    /// Stop posting when the flag is set (nullptr - never stop).
+    void stop_on(std::atomic<bool> const* const flag) noexcept {
+        cancelled_ = flag;
+    }
+
+    void line(std::string const& text, int const ref = -1) override {
+        stage::Scope const scope{stage::Post};
+        if (lines_ and not cancelled())
+            EventController::instance().post_text(lines_, event::AppendLine, text, ref);
+    }
+
+    void highlight(Match&& match) override {
+        highlights_.push_back(std::move(match));
+    }
+
+    void finish() override {
+        flush();
+    }
+
+    /// Send all collected matches to highlighting.
+    void flush() const noexcept {
+        if (not highlights_target_ or cancelled())
+            return;
+        stage::Scope const scope{stage::Serialize};
+        EventController::instance().post_text(highlights_target_, event::Match, glz::write_json(highlights_));
+    }
+
+    /// Forget collected matches (new run).
+    void clear() noexcept {
+        highlights_ = {};
+    }
+
+private:
+    [[nodiscard]] bool cancelled() const noexcept {
+        return cancelled_ and cancelled_->load(std::memory_order_relaxed);
+    }
+};
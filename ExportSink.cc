@@ -0,0 +1,187 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "ExportSink.h"
+#include <fmt/core.h>
+#include <glaze/glaze.hpp>
+#include <iterator>
+#include <utility>
+
+/*------- BufferedFile:
+-------------------------------------------------------------------*/
+BufferedFile::BufferedFile(std::string const& path) noexcept :
+    file_{path.empty() ? std::tmpfile() : std::fopen(path.c_str(), "wb")}
+{
+    if (file_)
+        // Our buffer is large enough, stdio would only copy the data once more.
+        std::setvbuf(file_, nullptr, _IONBF, 0);
+    buffer_.reserve(Capacity);
+}
+
+BufferedFile::~BufferedFile() {
+    if (file_) {
+        flush();
+        std::fclose(file_);
+    }
+}
+
+void BufferedFile::pad(u64 const alignment) noexcept {
+    static constexpr char zeros[16]{};
+    if (auto const rest = size() % alignment; rest)
+        write({zeros, std::size_t(alignment - rest)});
+}
+
+void BufferedFile::flush() noexcept {
+    if (buffer_.empty())
+        return;
+    if (not file_ or std::fwrite(buffer_.data(), 1, buffer_.size(), file_) not_eq buffer_.size())
+        failed_ = true;
+    written_ += buffer_.size();
+    buffer_.clear();
+}
+
+void BufferedFile::append(BufferedFile& other) noexcept {
+    flush();
+    auto const read = other.read([this](std::string_view const chunk) {
+        if (not file_ or std::fwrite(chunk.data(), 1, chunk.size(), file_) not_eq chunk.size())
+            failed_ = true;
+        written_ += chunk.size();
+    });
+    if (not read)
+        failed_ = true;
+}
+
+bool BufferedFile::read(std::function<void(std::string_view)> const& chunk) noexcept {
+    flush();
+    if (not valid())
+        return false;
+    std::rewind(file_);
+    buffer_.resize(Capacity);
+    while (auto const n = std::fread(buffer_.data(), 1, Capacity, file_))
+        chunk({buffer_.data(), n});
+    buffer_.clear();
+    auto const ok = not std::ferror(file_);
+    // Writing may go on (after reading the stream must be positioned).
+    std::fseek(file_, 0, SEEK_END);
+    return ok;
+}
+
+/*------- ExportSink:
+-------------------------------------------------------------------*/
+ExportSink::ExportSink(std::string path, Format const format, std::unique_ptr<BufferedFile> file) :
+    path_{std::move(path)},
+    format_{format},
+    file_{std::move(file)}
+{
+    switch (format_) {
+        case Format::Ndjson:
+            break;
+        case Format::Csv:
+            file_->write("line,nr,pos,length,str\n");
+            break;
+        case Format::Columnar:
+            columns_ = std::make_unique<Columns>();
+            break;
+    }
+}
+
+std::unique_ptr<ExportSink> ExportSink::create(std::string const& path, Format const format) noexcept {
+    auto file = std::make_unique<BufferedFile>(path);
+    if (not file->valid()) {
+        fmt::print(stderr, "ERROR: can't create the file '{}'\n", path);
+        return {};
+    }
+    return std::unique_ptr<ExportSink>(new ExportSink(path, format, std::move(file)));
+}
+
+ExportSink::Format ExportSink::format_for(std::string_view const path) noexcept {
+    if (path.ends_with(".ndjson") or path.ends_with(".jsonl"))
+        return Format::Ndjson;
+    if (path.ends_with(".csv"))
+        return Format::Csv;
+    return Format::Columnar;
+}
+
+void ExportSink::highlight(Match&& match) {
+    ++count_;
+    switch (format_) {
+        case Format::Ndjson:
+            record_ = glz::write_json(match);
+            record_ += '\n';
+            file_->write(record_);
+            return;
+        case Format::Csv: {
+            record_.clear();
+            fmt::format_to(std::back_inserter(record_), "{},{},{},{},\"", match.line, match.nr, match.pos, match.length);
+            for (auto const c : match.str) {
+                if (c == '"')
+                    record_ += '"';
+                record_ += c;
+            }
+            record_ += "\"\n";
+            file_->write(record_);
+            return;
+        }
+        case Format::Columnar:
+            columns_->line.write_raw(i32(match.line));
+            columns_->group.write_raw(i32(match.nr));
+            columns_->offset.write_raw(i64(match.pos));
+            columns_->length.write_raw(i64(match.length));
+            columns_->blob.write(match.str);
+            columns_->end.write_raw(u64(columns_->blob.size()));
+            return;
+    }
+}
+
+void ExportSink::finish() {
+    if (finished_)
+        return;
+    finished_ = true;
+
+    if (columns_) {
+        // Sections are known only now - they are joined after the header.
+        auto const align = [](u64 const n) { return (n + 7) / 8 * 8; };
+        Header header{};
+        header.count = count_;
+        header.blob = columns_->blob.size();
+        header.offsets[0] = align(sizeof(Header));
+        header.offsets[1] = align(header.offsets[0] + count_ * sizeof(i32));
+        header.offsets[2] = align(header.offsets[1] + count_ * sizeof(i32));
+        header.offsets[3] = header.offsets[2] + count_ * sizeof(i64);
+        header.offsets[4] = header.offsets[3] + count_ * sizeof(i64);
+        header.offsets[5] = header.offsets[4] + count_ * sizeof(u64);
+        file_->write_raw(header);
+        for (auto const column : {&columns_->line, &columns_->group, &columns_->offset,
+                                  &columns_->length, &columns_->end, &columns_->blob}) {
+            file_->pad(8);
+            file_->append(*column);
+        }
+        columns_.reset();
+    }
+    file_->flush();
+    bytes_ = file_->size();
+    failed_ = not file_->valid();
+}
@@ -0,0 +1,155 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include "Sink.h"
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+/*------- classes:
+-------------------------------------------------------------------*/
+/// File written through a large buffer (one write call for many records).
+class BufferedFile {
+    std::FILE* file_{};
+    std::string buffer_{};
+    u64 written_{};
+    bool failed_{};
+    static constexpr std::size_t Capacity = 1 << 20;
+public:
+    /// Opens the file for writing (or an anonymous temporary file if the path is empty).
+    explicit BufferedFile(std::string const& path = {}) noexcept;
+    ~BufferedFile();
+    BufferedFile(BufferedFile const&) = delete;
+    BufferedFile& operator=(BufferedFile const&) = delete;
+
+    [[nodiscard]] bool valid() const noexcept {
+        return file_ not_eq nullptr and not failed_;
+    }
+    /// Number of bytes written so far (with the buffered ones).
+    [[nodiscard]] u64 size() const noexcept {
+        return written_ + buffer_.size();
+    }
+
+    void write(std::string_view const data) noexcept {
+        buffer_.append(data);
+        if (buffer_.size() >= Capacity)
+            flush();
+    }
+    /// Writes the value as it is in memory (little-endian on all supported platforms).
+    template<typename T>
+    void write_raw(T const value) noexcept {
+        write({reinterpret_cast<char const*>(&value), sizeof(T)});
+    }
+    /// Zeros up to the next multiple of the alignment.
+    void pad(u64 alignment) noexcept;
+
+    /// Sends the buffer to the file.
+    void flush() noexcept;
+
+    /// Appends the whole content of the other (temporary) file.
+    void append(BufferedFile& other) noexcept;
+
+    /// Reads the whole content of the (temporary) file from the start, chunk by chunk.
+    /// \param chunk - receiver of read data,
+    /// \return false if the file could not be read.
+    bool read(std::function<void(std::string_view)> const& chunk) noexcept;
+};
+
+/// Sink that streams matches to a file while the run is in progress. \n
+/// Only matches are exported (lines for the matches-view are ignored), nothing is kept in memory.
+/// Formats:
+/// - NDJSON   - one Match object per line,
+/// - CSV      - header and one quoted row per match,
+/// - Columnar - fixed-width arrays of all matches and a string blob (see Header),
+///              any section can be mapped and used as an array without parsing.
+class ExportSink : public Sink {
+public:
+    enum class Format { Ndjson, Csv, Columnar };
+
+    /// Header of the columnar file. \n
+    /// Sections follow in the order of the offsets, each starts at a multiple of 8:
+    /// line i32[count], group i32[count], offset i64[count], length i64[count],
+    /// end u64[count] (end of the string of the match in the blob), blob (UTF-8 strings).
+    struct Header {
+        char magic[8]{'C', 'R', 'G', 'X', 'C', 'O', 'L', '1'};
+        u64 count{};
+        u64 blob{};
+        u64 offsets[6]{};
+    };
+
+    /// Creates the sink writing to the file.
+    /// \return the sink or nullptr if the file cannot be created.
+    static std::unique_ptr<ExportSink> create(std::string const& path, Format format) noexcept;
+
+    /// The format for the file extension (.ndjson, .jsonl, .csv, others - columnar).
+    static Format format_for(std::string_view path) noexcept;
+
+    void line(std::string const&, int) override {}
+    void highlight(Match&& match) override;
+    void finish() override;
+
+    [[nodiscard]] std::string const& path() const noexcept {
+        return path_;
+    }
+    [[nodiscard]] u64 count() const noexcept {
+        return count_;
+    }
+    /// Size of the written file (valid after finish).
+    [[nodiscard]] u64 bytes() const noexcept {
+        return bytes_;
+    }
+    /// Checks if something could not be written.
+    [[nodiscard]] bool failed() const noexcept {
+        return failed_;
+    }
+
+private:
+    ExportSink(std::string path, Format format, std::unique_ptr<BufferedFile> file);
+
+    /// Columns of the columnar format (temporary files joined by finish).
+    struct Columns {
+        BufferedFile line{};
+        BufferedFile group{};
+        BufferedFile offset{};
+        BufferedFile length{};
+        BufferedFile end{};
+        BufferedFile blob{};
+    };
+
+    std::string path_;
+    Format format_;
+    std::unique_ptr<BufferedFile> file_;
+    std::unique_ptr<Columns> columns_{};
+    std::string record_{};
+    u64 count_{};
+    u64 bytes_{};
+    bool finished_{};
+    bool failed_{};
+};
@@ -0,0 +1,145 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+/*------- template class:
+-------------------------------------------------------------------*/
+/// Lazy sequence of values produced by a coroutine (co_yield). \n
+/// Values are produced on demand - the consumer that stops iterating
+/// never pays for the rest. The yielded value is valid until the next step.
+/// (Our compilers do not provide std::generator yet.)
+template<typename T>
+class Generator {
+public:
+    struct promise_type {
+        T const* value_{};
+        std::exception_ptr exception_{};
+
+        Generator get_return_object() noexcept {
+            return Generator{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_always final_suspend() const noexcept { return {}; }
+        // The yielded object lives in the coroutine frame while it is suspended.
+        std::suspend_always yield_value(T const& value) noexcept {
+            value_ = std::addressof(value);
+            return {};
+        }
+        void return_void() const noexcept {}
+        void unhandled_exception() noexcept {
+            exception_ = std::current_exception();
+        }
+    };
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    class iterator {
+        handle_type handle_{};
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(handle_type const handle) : handle_{handle} {}
+
+        T const& operator*() const noexcept {
+            return *handle_.promise().value_;
+        }
+        T const* operator->() const noexcept {
+            return handle_.promise().value_;
+        }
+        iterator& operator++() {
+            step(handle_);
+            return *this;
+        }
+        void operator++(int) {
+            ++*this;
+        }
+        bool operator==(std::default_sentinel_t) const noexcept {
+            return not handle_ or handle_.done();
+        }
+    };
+
+    Generator() = default;
+    explicit Generator(handle_type const handle) : handle_{handle} {}
+    Generator(Generator const&) = delete;
+    Generator& operator=(Generator const&) = delete;
+    Generator(Generator&& other) noexcept : handle_{std::exchange(other.handle_, {})} {}
+    Generator& operator=(Generator&& other) noexcept {
+        if (this not_eq &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    ~Generator() {
+        if (handle_) handle_.destroy();
+    }
+
+    iterator begin() {
+        step(handle_);
+        return iterator{handle_};
+    }
+    std::default_sentinel_t end() const noexcept {
+        return {};
+    }
+
+    /// Produces the next value (for resumable consumers).
+    /// \return pointer to the value or nullptr if there are no more values.
+    T const* next() {
+        step(handle_);
+        return (handle_ and not handle_.done()) ? handle_.promise().value_ : nullptr;
+    }
+
+    /// The value produced by the last step (next() or the iterator), the sequence is not resumed.
+    /// \return pointer to the value or nullptr if there are no more values.
+    [[nodiscard]] T const* current() const noexcept {
+        return (handle_ and not handle_.done()) ? handle_.promise().value_ : nullptr;
+    }
+
+    /// Checks if the sequence is exhausted.
+    [[nodiscard]] bool done() const noexcept {
+        return not handle_ or handle_.done();
+    }
+
+private:
+    static void step(handle_type const handle) {
+        if (not handle or handle.done())
+            return;
+        handle.resume();
+        if (handle.done())
+            if (auto const e = handle.promise().exception_; e)
+                std::rethrow_exception(e);
+    }
+
+    handle_type handle_{};
+};
@@ -0,0 +1,123 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Stage.h"
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+#if defined(__GLIBC__)
+    #include <malloc.h>
+#endif
+
+/*------- hook of the allocator:
+-------------------------------------------------------------------*/
+// Every allocation of the process (Qt's and PCRE2's too) is counted for the thread that makes it.
+// Linked only to benchmarks and to builds with HEAP_PROFILE (it costs some atomics per allocation).
+#if defined(__GLIBC__)
+extern "C" {
+    void* __libc_malloc(std::size_t);
+    void* __libc_calloc(std::size_t, std::size_t);
+    void* __libc_realloc(void*, std::size_t);
+    void* __libc_memalign(std::size_t, std::size_t);
+    void __libc_free(void*);
+}
+
+namespace {
+    void* counted(void* const p, std::size_t const n) noexcept {
+        if (p)
+            stage::heap::allocated(n, malloc_usable_size(p));
+        return p;
+    }
+}
+
+extern "C" {
+    void* malloc(std::size_t const n) noexcept {
+        return counted(__libc_malloc(n), n);
+    }
+    void* calloc(std::size_t const count, std::size_t const n) noexcept {
+        return counted(__libc_calloc(count, n), count * n);
+    }
+    void* realloc(void* const p, std::size_t const n) noexcept {
+        auto const size = p ? malloc_usable_size(p) : 0;
+        auto const q = __libc_realloc(p, n);
+        // The old block is freed only if the new one was given.
+        if (q or n == 0)
+            stage::heap::freed(size);
+        return counted(q, n);
+    }
+    void* memalign(std::size_t const alignment, std::size_t const n) noexcept {
+        return counted(__libc_memalign(alignment, n), n);
+    }
+    void* aligned_alloc(std::size_t const alignment, std::size_t const n) noexcept {
+        return counted(__libc_memalign(alignment, n), n);
+    }
+    int posix_memalign(void** const p, std::size_t const alignment, std::size_t const n) noexcept {
+        if (alignment < sizeof(void*) or (alignment & (alignment - 1)))
+            return EINVAL;
+        if (auto const q = counted(__libc_memalign(alignment, n), n); q) {
+            *p = q;
+            return 0;
+        }
+        return ENOMEM;
+    }
+    void free(void* const p) noexcept {
+        if (p)
+            stage::heap::freed(malloc_usable_size(p));
+        __libc_free(p);
+    }
+}
+#else
+// Without glibc only C++ allocations are visible (the size is kept before the block).
+namespace {
+    constexpr std::size_t Header = alignof(std::max_align_t);
+}
+void* operator new(std::size_t const n) {
+    if (auto const p = static_cast<char*>(std::malloc(n + Header)); p) {
+        *reinterpret_cast<std::size_t*>(p) = n;
+        stage::heap::allocated(n, n + Header);
+        return p + Header;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* const p) noexcept {
+    if (not p)
+        return;
+    auto const block = static_cast<char*>(p) - Header;
+    stage::heap::freed(*reinterpret_cast<std::size_t*>(block) + Header);
+    std::free(block);
+}
+void operator delete(void* const p, std::size_t) noexcept {
+    operator delete(p);
+}
+#endif
+
+namespace {
+    // Reports of runs show allocations only when they are counted.
+    [[maybe_unused]] bool const installed = [] {
+        stage::heap::hooked.store(true);
+        return true;
+    }();
+}
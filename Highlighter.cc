@@ -26,7 +26,8 @@
 -------------------------------------------------------------------*/
 #include "Highlighter.h"
 #include <QTextDocument>
-#include <fmt/core.h>
+#include <QTextBlock>
+#include <algorithm>
 
 Highlighter::Highlighter(QTextDocument* const parent) : QSyntaxHighlighter(parent) {
     auto const n = 5;
@@ -38,16 +39,41 @@ Highlighter::Highlighter(QTextDocument* const parent) : QSyntaxHighlighter(paren
     }
 }
 
+void Highlighter::upate_for(std::vector<Match> data) noexcept {
+    data_ = std::move(data);
+    split();
+    // Sorted by lines, every block finds its matches with binary search.
+    std::ranges::stable_sort(data_, {}, &Match::line);
+    action_ = true;
+    rehighlight();
+}
+
+void Highlighter::split() noexcept {
+    // Matches found in the whole document may span lines,
+    // every block gets its own part (the newline is one position).
+    auto const n = data_.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        if (data_[i].nr not_eq 0) continue;
+        auto block = document()->findBlockByNumber(data_[i].line);
+        auto const room = block.length() - 1 - data_[i].pos;
+        if (not block.isValid() or data_[i].length <= room) continue;
+
+        auto rest = data_[i].length - room - 1;
+        data_[i].length = room;
+        for (block = block.next(); block.isValid() and rest > 0; block = block.next()) {
+            auto const part = std::min(rest, block.length() - 1);
+            data_.push_back(Match{.line = block.blockNumber(), .nr = 0, .pos = 0, .length = part});
+            rest -= part + 1;
+        }
+    }
+}
+
 void Highlighter::highlightBlock(qstr const& line) {
     if (not action_ or line.isEmpty() or data_.empty()) return;
 
-    fmt::print("Line: {}\n", line.toStdString());
-    auto text = line.toStdString();
-    for (auto const& match : data_)
-        if (text.contains(match.str)) {
-            if (match.nr == 0) {
-                setFormat(match.pos, match.length, format_[0]);
-                fmt::print("-- {}\n", match.as_str());
-            }
-        }
+    // Positions in matches are QString (UTF-16) positions in the line.
+    auto const [first, last] = std::ranges::equal_range(data_, currentBlock().blockNumber(), {}, &Match::line);
+    for (auto it = first; it not_eq last; ++it)
+        if (it->nr == 0)
+            setFormat(it->pos, it->length, format_[0]);
 }
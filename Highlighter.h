@@ -47,11 +47,8 @@ public:
     Highlighter& operator=(Highlighter const&) = delete;
     Highlighter& operator=(Highlighter&&) = delete;
 
-    void upate_for(std::vector<Match> data) noexcept {
-        data_ = std::move((data));
-        action_ = true;
-        rehighlight();
-    };
+    /// Highlight matches (of all lines of the document).
+    void upate_for(std::vector<Match> data) noexcept;
 
     bool action() const noexcept {
         return action_;
@@ -62,6 +59,9 @@ public:
 private:
     void highlightBlock(qstr const& text) override;
 
+    /// Split matches which span lines into parts for every line.
+    void split() noexcept;
+
     bool action_{};
     std::vector<Match> data_{};
 };
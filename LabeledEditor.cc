@@ -27,7 +27,6 @@
 #include "Editor.h"
 #include "Settings.h"
 #include "LabeledEditor.h"
-#include "EventController.h"
 #include <QLabel>
 #include <QBoxLayout>
 
@@ -40,10 +39,9 @@ LabeledEditor::LabeledEditor(
     QWidget(parent),
     editor_{new Editor(highlighting)}
 {
-    if (read_only == ReadOnly::Yes) {
+    // Lines of results are posted directly to the editor (EventSink).
+    if (read_only == ReadOnly::Yes)
         editor_->setReadOnly(true);
-        EventController::instance().append(editor_, event::AppendLine);
-    }
 
     auto p = palette();
     p.setColor(QPalette::Base, Settings::BackgroundColor);
@@ -57,6 +57,13 @@ public:
     void set(strings text) const noexcept {
         editor_->set(std::move(text));
     }
+    /// The editor itself (receiver of events with results).
+    [[nodiscard]] Editor* editor() const noexcept {
+        return editor_;
+    }
+    void set_details(Editor::Details details) const noexcept {
+        editor_->set_details(std::move(details));
+    }
 private:
     Editor* const editor_;
 };
@@ -0,0 +1,57 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include "Simd.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// Offsets where lines of the text start (found with a vectorized newline scan). \n
+/// Translates positions in the whole text to (line, column) - both in QString units.
+class LineIndex {
+    std::vector<isize> starts_{0};
+public:
+    explicit LineIndex(qstr const& text) {
+        simd::for_each_newline(reinterpret_cast<char16_t const*>(text.utf16()), std::size_t(text.size()),
+                               [this](std::size_t const i) { starts_.push_back(isize(i) + 1); });
+    }
+
+    /// Number of lines (the text without '\n' has one).
+    [[nodiscard]] isize lines() const noexcept {
+        return isize(starts_.size());
+    }
+
+    /// Line and column of the position in the text.
+    [[nodiscard]] std::pair<int, isize> locate(isize const pos) const noexcept {
+        auto const it = std::ranges::upper_bound(starts_, pos);
+        auto const line = std::distance(starts_.cbegin(), it) - 1;
+        return {int(line), pos - starts_[std::size_t(line)]};
+    }
+};
@@ -0,0 +1,52 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Literal.h"
+#include <string_view>
+
+Generator<Literal::Hit> Literal::matches(char const* const subject, std::size_t const n) const {
+    // string_view::find searches the first byte with memchr.
+    std::string_view const text{subject, n};
+    auto const size = bytes_.size();
+    for (auto pos = text.find(bytes_); pos not_eq std::string_view::npos; pos = text.find(bytes_, pos + size))
+        co_yield Hit{isize(pos), isize(size)};
+}
+
+Generator<Literal::Hit> Literal::matches(qstr const& subject) const {
+    auto const size = text_.size();
+    for (auto pos = subject.indexOf(text_); pos >= 0; pos = subject.indexOf(text_, pos + size))
+        co_yield Hit{pos, size};
+}
+
+bool Literal::is_literal(qstr const& pattern) noexcept {
+    static constexpr std::u16string_view meta = u"\\^$.|?*+()[]{}";
+    if (pattern.isEmpty())
+        return false;
+    for (auto const c : pattern)
+        if (meta.find(c.unicode()) not_eq std::u16string_view::npos)
+            return false;
+    return true;
+}
@@ -0,0 +1,63 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include "Generator.h"
+#include <string>
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// Plain substring search for patterns without any metacharacters. \n
+/// Used instead of a regex engine when only the existence or the number
+/// of matches is needed (memchr/SIMD speed, no engine machinery).
+class Literal {
+    std::string bytes_;
+    qstr text_;
+public:
+    /// One match - the literal has no groups.
+    struct Hit {
+        isize pos;
+        isize len;
+
+        [[nodiscard]] int groups() const noexcept { return 1; }
+        [[nodiscard]] isize start(int) const noexcept { return pos; }
+        [[nodiscard]] isize length(int) const noexcept { return len; }
+    };
+
+    explicit Literal(qstr const& pattern) :
+        bytes_{pattern.toStdString()},
+        text_{pattern}
+    {}
+
+    /// Searches (not overlapping) occurrences in UTF-8 bytes.
+    [[nodiscard]] Generator<Hit> matches(char const* subject, std::size_t n) const;
+    /// Searches (not overlapping) occurrences in QString.
+    [[nodiscard]] Generator<Hit> matches(qstr const& subject) const;
+
+    /// Checks if the pattern means itself in every supported grammar.
+    static bool is_literal(qstr const& pattern) noexcept;
+};
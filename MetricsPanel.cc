@@ -0,0 +1,144 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "MetricsPanel.h"
+#include "Settings.h"
+#include <QBoxLayout>
+#include <QClipboard>
+#include <QFontDatabase>
+#include <QGuiApplication>
+#include <QListWidget>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QToolButton>
+#include <fmt/core.h>
+
+/*------- local constants:
+-------------------------------------------------------------------*/
+char const* const MetricsPanel::Title = QT_TR_NOOP("Metrics");
+char const* const MetricsPanel::CopyJson = QT_TR_NOOP("Copy JSON");
+char const* const MetricsPanel::NoRun = QT_TR_NOOP("No measurements (start a run).");
+
+/*------- class implementation:
+-------------------------------------------------------------------*/
+MetricsPanel::MetricsPanel(QWidget* const parent) :
+    QWidget(parent),
+    toggle_{new QToolButton},
+    copy_{new QPushButton{tr(CopyJson)}},
+    view_{new QPlainTextEdit},
+    slowest_{new QListWidget}
+{
+    auto p = palette();
+    p.setColor(QPalette::Base, Settings::BackgroundColor);
+    setAutoFillBackground(true);
+    setPalette(p);
+
+    toggle_->setText(tr(Title));
+    toggle_->setCheckable(true);
+    toggle_->setToolButtonStyle(Qt::ToolButtonTextBesideIcon);
+    toggle_->setAutoRaise(true);
+    auto font = toggle_->font();
+    font.setPointSize(11);
+    toggle_->setFont(font);
+    connect(toggle_, &QToolButton::toggled, this, &MetricsPanel::expand);
+
+    copy_->setEnabled(false);
+    connect(copy_, &QPushButton::clicked, this, &MetricsPanel::copy_json);
+
+    view_->setReadOnly(true);
+    view_->setLineWrapMode(QPlainTextEdit::NoWrap);
+    view_->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    view_->setPlainText(tr(NoRun));
+
+    // Double click (or Enter) shows the line in the source-editor.
+    slowest_->setFont(view_->font());
+    connect(slowest_, &QListWidget::itemActivated, this, [this](QListWidgetItem const* const item) {
+        if (jump_)
+            jump_(item->data(Qt::UserRole).toInt());
+    });
+
+    auto header_layout{new QHBoxLayout};
+    header_layout->setContentsMargins(0, 2, 2, 2);
+    header_layout->setSpacing(0);
+    header_layout->addWidget(toggle_);
+    header_layout->addStretch();
+    header_layout->addWidget(copy_);
+
+    auto main_layout{new QVBoxLayout};
+    main_layout->setSpacing(Settings::NoSpacing);
+    main_layout->setContentsMargins(Settings::NoMargins);
+    main_layout->addLayout(header_layout);
+    main_layout->addWidget(view_);
+    main_layout->addWidget(slowest_);
+    setLayout(main_layout);
+
+    // Collapsed - the run is not disturbed by one more view.
+    expand(false);
+}
+
+void MetricsPanel::set(RunStats stats) noexcept {
+    stats_ = std::move(stats);
+    show_stats();
+    copy_->setEnabled(true);
+}
+
+void MetricsPanel::set_stages(std::vector<StageStats> stages) noexcept {
+    // Nothing is shown - the run did not measure itself.
+    if (not copy_->isEnabled())
+        return;
+    stats_.stages = std::move(stages);
+    show_stats();
+}
+
+void MetricsPanel::show_stats() noexcept {
+    qstrings lines;
+    for (auto const& line : stats_.lines())
+        lines.push_back(qstr::fromStdString(line));
+    view_->setPlainText(lines.join('\n'));
+    slowest_->clear();
+    for (auto const& [line, us] : stats_.slowest) {
+        auto const text = fmt::format("line {}: {}", line + 1, RunStats::duration(us));
+        auto const item = new QListWidgetItem(qstr::fromStdString(text), slowest_);
+        item->setData(Qt::UserRole, int(line));
+    }
+}
+
+void MetricsPanel::clear() noexcept {
+    stats_ = {};
+    view_->setPlainText(tr(NoRun));
+    slowest_->clear();
+    copy_->setEnabled(false);
+}
+
+void MetricsPanel::expand(bool const flag) noexcept {
+    toggle_->setArrowType(flag ? Qt::DownArrow : Qt::RightArrow);
+    view_->setVisible(flag);
+    slowest_->setVisible(flag);
+}
+
+void MetricsPanel::copy_json() const noexcept {
+    QGuiApplication::clipboard()->setText(qstr::fromStdString(stats_.to_json(true)));
+}
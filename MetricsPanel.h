@@ -0,0 +1,80 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include "model/Stats.h"
+#include <QWidget>
+#include <functional>
+
+/*------- forward declarations:
+-------------------------------------------------------------------*/
+class QToolButton;
+class QPushButton;
+class QPlainTextEdit;
+class QListWidget;
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// Collapsible panel with measurements of the last run (times, throughput, memory, cache,
+/// latency of lines). Measurements can be copied as JSON, the slowest lines can be shown in the source.
+class MetricsPanel : public QWidget {
+public:
+    /// Receiver of the line chosen from the slowest lines (number from 0).
+    using Jump = std::function<void(int)>;
+
+    explicit MetricsPanel(QWidget* = nullptr);
+    ~MetricsPanel() override = default;
+
+    /// Set receiver of chosen lines (nothing if empty).
+    void set_jump(Jump jump) noexcept {
+        jump_ = std::move(jump);
+    }
+
+    /// Show measurements of the finished run.
+    void set(RunStats stats) noexcept;
+    /// Add stages of the run shown (they end after the run - with the last events).
+    void set_stages(std::vector<StageStats> stages) noexcept;
+    /// Nothing to show (the run did not measure itself).
+    void clear() noexcept;
+
+private:
+    /// Show or hide the content (the header is always visible).
+    void expand(bool flag) noexcept;
+    void show_stats() noexcept;
+    void copy_json() const noexcept;
+
+    QToolButton* const toggle_;
+    QPushButton* const copy_;
+    QPlainTextEdit* const view_;
+    QListWidget* const slowest_;
+    RunStats stats_{};
+    Jump jump_{};
+
+    static char const* const Title;
+    static char const* const CopyJson;
+    static char const* const NoRun;
+};
@@ -33,8 +33,14 @@
 #include <QPushButton>
 #include <QApplication>
 #include <QRadioButton>
+#include <QSpinBox>
+#include <QLineEdit>
+#include <QRegularExpression>
 #include <iostream>
 #include <glaze/glaze.hpp>
+#ifdef PCRE2_REGEX
+    #include "RegexPcre.h"
+#endif
 
 /*------- local constants:
 -------------------------------------------------------------------*/
@@ -52,8 +58,33 @@ char const * const OptionsWidget::NoSubs = QT_TR_NOOP("nosubs [marked sub-expres
 char const * const OptionsWidget::Optimize = QT_TR_NOOP("optimize [slower construction, faster matching]");
 char const * const OptionsWidget::Collate = QT_TR_NOOP("collate [locale sensitive]");
 char const * const OptionsWidget::Multiline = QT_TR_NOOP("multiline");
+char const * const OptionsWidget::Bytes = QT_TR_NOOP("bytes [pcre2: no UTF, raw bytes]");
+char const * const OptionsWidget::AnyMatch = QT_TR_NOOP("any match [matching lines only]");
+char const * const OptionsWidget::CountOnly = QT_TR_NOOP("count only [no captures]");
+char const * const OptionsWidget::OffsetsOnly = QT_TR_NOOP("offsets only [no strings]");
+char const * const OptionsWidget::FullCaptures = QT_TR_NOOP("full captures [default]");
+char const * const OptionsWidget::OnDemand = QT_TR_NOOP("groups on demand [whole matches first]");
+char const * const OptionsWidget::GroupBy = QT_TR_NOOP("group by [top values of the group]");
+char const * const OptionsWidget::Group = QT_TR_NOOP("group: $");
+char const * const OptionsWidget::StopAfter = QT_TR_NOOP("stop after: ");
+char const * const OptionsWidget::NoLimit = QT_TR_NOOP("all matches");
+char const * const OptionsWidget::Sliced = QT_TR_NOOP("cooperative [GUI thread, time slices]");
+char const * const OptionsWidget::BenchmarkRuns = QT_TR_NOOP("benchmark runs: ");
+char const * const OptionsWidget::Metrics = QT_TR_NOOP("metrics in matches [after the run]");
+char const * const OptionsWidget::ReplaceWith = QT_TR_NOOP("replace with ($1 - std/pcre2, \\1 - qt)");
+char const * const OptionsWidget::Preview = QT_TR_NOOP("preview: ");
+char const * const OptionsWidget::ReplaceToFile = QT_TR_NOOP("Replace to File ...");
+char const * const OptionsWidget::ReplaceToTab = QT_TR_NOOP("Replace to Tab");
+char const * const OptionsWidget::WholeDocument = QT_TR_NOOP("whole document [matches may span lines]");
 
 char const * const OptionsWidget::Run = QT_TR_NOOP("Run");
+char const * const OptionsWidget::Benchmark = QT_TR_NOOP("Benchmark");
+char const * const OptionsWidget::Profile = QT_TR_NOOP("Profile");
+char const * const OptionsWidget::More = QT_TR_NOOP("More");
+char const * const OptionsWidget::Sample = QT_TR_NOOP("Sample");
+char const * const OptionsWidget::RunAll = QT_TR_NOOP("Run All Tabs");
+char const * const OptionsWidget::Export = QT_TR_NOOP("Export ...");
+char const * const OptionsWidget::Trace = QT_TR_NOOP("Trace");
 char const * const OptionsWidget::ClearAll = QT_TR_NOOP("Clear");
 char const * const OptionsWidget::ClearMatches = QT_TR_NOOP("Clear Matches");
 char const * const OptionsWidget::Exit = QT_TR_NOOP("Exit");
@@ -76,16 +107,53 @@ OptionsWidget::OptionsWidget(QWidget* const parent) :
     optimize_{new QCheckBox{tr(Optimize)}},
     collate_{new QCheckBox{tr(Collate)}},
     multiline_{new QCheckBox{tr(Multiline)}},
+    bytes_{new QCheckBox{tr(Bytes)}},
+    any_{new QRadioButton{tr(AnyMatch)}},
+    count_{new QRadioButton{tr(CountOnly)}},
+    offsets_{new QRadioButton{tr(OffsetsOnly)}},
+    full_{new QRadioButton{tr(FullCaptures)}},
+    on_demand_{new QRadioButton{tr(OnDemand)}},
+    group_by_{new QRadioButton{tr(GroupBy)}},
+    group_{new QSpinBox},
+    limit_{new QSpinBox},
+    document_{new QCheckBox{tr(WholeDocument)}},
+    sliced_{new QCheckBox{tr(Sliced)}},
+    runs_{new QSpinBox},
+    metrics_{new QCheckBox{tr(Metrics)}},
+    replacement_{new QLineEdit},
+    preview_{new QSpinBox},
+    replace_{new QPushButton{tr(ReplaceToFile)}},
+    replace_tab_{new QPushButton{tr(ReplaceToTab)}},
     run_{new QPushButton{tr(Run)}},
+    benchmark_{new QPushButton{tr(Benchmark)}},
+    profile_{new QPushButton{tr(Profile)}},
+    more_{new QPushButton{tr(More)}},
+    sample_{new QPushButton{tr(Sample)}},
+    run_all_{new QPushButton{tr(RunAll)}},
+    export_{new QPushButton{tr(Export)}},
+    trace_{new QPushButton{tr(Trace)}},
     clear_all_{new QPushButton{tr(ClearAll)}},
     clear_matches_{new QPushButton{tr(ClearMatches)}},
     exit_{new QPushButton{tr(Exit)}}
 {
     std_->setChecked(true);
     ecma_->setChecked(true);
-    // actually implemented only std version
-    qt_->setEnabled(false);
-    pcre2_->setEnabled(false);
+    full_->setChecked(true);
+    group_->setRange(0, 99);
+    group_->setValue(1);
+    group_->setPrefix(tr(Group));
+    // 0 - no limit (the scan runs to the end).
+    limit_->setRange(0, 1'000'000);
+    limit_->setSingleStep(100);
+    limit_->setSpecialValueText(tr(NoLimit));
+    limit_->setPrefix(tr(StopAfter));
+    replacement_->setPlaceholderText(tr(ReplaceWith));
+    preview_->setRange(0, 10'000);
+    preview_->setValue(20);
+    preview_->setPrefix(tr(Preview));
+    runs_->setRange(1, 1'000);
+    runs_->setValue(10);
+    runs_->setPrefix(tr(BenchmarkRuns));
 
     auto standard_group{new QGroupBox{"Tool"}};
     auto standard_layout{new QVBoxLayout};
@@ -113,10 +181,49 @@ OptionsWidget::OptionsWidget(QWidget* const parent) :
     variation_layout->addWidget(optimize_);
     variation_layout->addWidget(collate_);
     variation_layout->addWidget(multiline_);
+#ifdef PCRE2_REGEX
+    variation_layout->addWidget(bytes_);
+#endif
     variation_group->setLayout(variation_layout);
 
+    auto results_group{new QGroupBox{"Results"}};
+    auto results_layout{new QVBoxLayout};
+    results_layout->addWidget(any_);
+    results_layout->addWidget(count_);
+    results_layout->addWidget(offsets_);
+    results_layout->addWidget(full_);
+    results_layout->addWidget(on_demand_);
+    results_layout->addWidget(group_by_);
+    results_layout->addWidget(group_);
+    results_layout->addWidget(limit_);
+    results_layout->addWidget(document_);
+    results_layout->addWidget(sliced_);
+    results_layout->addWidget(runs_);
+    results_layout->addWidget(metrics_);
+    results_group->setLayout(results_layout);
+
+    auto replace_group{new QGroupBox{"Replace"}};
+    auto replace_layout{new QVBoxLayout};
+    replace_layout->addWidget(replacement_);
+    replace_layout->addWidget(preview_);
+    auto replace_buttons_layout{new QHBoxLayout};
+    replace_buttons_layout->addWidget(replace_);
+    replace_buttons_layout->addWidget(replace_tab_);
+    replace_layout->addLayout(replace_buttons_layout);
+    replace_group->setLayout(replace_layout);
+
     auto buttons_layout{new QHBoxLayout};
     buttons_layout->addWidget(run_);
+    buttons_layout->addWidget(benchmark_);
+#ifdef PCRE2_REGEX
+    // Backtracking is profiled with PCRE2 callouts.
+    buttons_layout->addWidget(profile_);
+#endif
+    buttons_layout->addWidget(more_);
+    buttons_layout->addWidget(sample_);
+    buttons_layout->addWidget(run_all_);
+    buttons_layout->addWidget(export_);
+    buttons_layout->addWidget(trace_);
     buttons_layout->addWidget(clear_all_);
     buttons_layout->addWidget(clear_matches_);
 
@@ -128,6 +235,8 @@ OptionsWidget::OptionsWidget(QWidget* const parent) :
     main_layout->addWidget(standard_group);
     main_layout->addWidget(grammar_group);
     main_layout->addWidget(variation_group);
+    main_layout->addWidget(results_group);
+    main_layout->addWidget(replace_group);
     main_layout->addStretch(4);
     main_layout->addLayout(buttons_layout);
     main_layout->addStretch(100);
@@ -140,23 +249,100 @@ OptionsWidget::OptionsWidget(QWidget* const parent) :
     setMaximumWidth(w);
 
     connect(run_, &QPushButton::pressed, this, &OptionsWidget::run_slot);
+    connect(benchmark_, &QPushButton::pressed, this, &OptionsWidget::benchmark_slot);
+    connect(profile_, &QPushButton::pressed, this, &OptionsWidget::profile_slot);
+    connect(more_, &QPushButton::pressed, this, &OptionsWidget::more);
+    connect(sample_, &QPushButton::pressed, this, &OptionsWidget::sample_slot);
+    connect(run_all_, &QPushButton::pressed, this, &OptionsWidget::run_all_slot);
+    connect(export_, &QPushButton::pressed, this, &OptionsWidget::export_slot);
+    // Pressed - recording, released - the trace is written to a file.
+    trace_->setCheckable(true);
+    connect(trace_, &QPushButton::toggled, this, &OptionsWidget::trace_slot);
+    connect(replace_, &QPushButton::pressed, this, &OptionsWidget::replace_slot);
+    connect(replace_tab_, &QPushButton::pressed, this, &OptionsWidget::replace_tab_slot);
+    // The group is used only by 'group by'.
+    group_->setEnabled(false);
+    connect(group_by_, &QRadioButton::toggled, group_, &QSpinBox::setEnabled);
     connect(clear_all_, &QPushButton::pressed, this, &OptionsWidget::claer_all);
     connect(clear_matches_, &QPushButton::pressed, this, &OptionsWidget::claer_matches);
     connect(exit_, &QPushButton::pressed, this, &QApplication::quit);
 }
 
 void OptionsWidget::run_slot() noexcept {
+    request(event::RunRequest);
+}
+
+void OptionsWidget::benchmark_slot() noexcept {
+    request(event::BenchmarkRequest);
+}
+
+void OptionsWidget::profile_slot() noexcept {
+    request(event::ProfileRequest);
+}
+
+void OptionsWidget::sample_slot() noexcept {
+    request(event::SampleRequest);
+}
+
+void OptionsWidget::run_all_slot() noexcept {
+    request(event::RunAllRequest);
+}
+
+void OptionsWidget::export_slot() noexcept {
+    request(event::ExportRequest);
+}
+
+void OptionsWidget::trace_slot(bool const checked) noexcept {
+    EventController::instance().send_event(event::TraceRequest, checked);
+}
+
+void OptionsWidget::replace_slot() noexcept {
+    request(event::ReplaceRequest);
+}
+
+void OptionsWidget::replace_tab_slot() noexcept {
+    request(event::ReplaceTabRequest);
+}
+
+qstr OptionsWidget::replacement() const noexcept {
+    return replacement_->text();
+}
+
+isize OptionsWidget::preview() const noexcept {
+    return preview_->value();
+}
+
+int OptionsWidget::runs() const noexcept {
+    return runs_->value();
+}
+
+bool OptionsWidget::metrics() const noexcept {
+    return metrics_->isChecked();
+}
+
+void OptionsWidget::request(int const id) const noexcept {
     auto tool = tool::Std;
     if (qt_->isChecked()) tool = tool::Qt;
     if (pcre2_->isChecked()) tool = tool::Pcre2;
 
+    auto const results = int(granularity());
+    auto const limit = limit_->value();
+    auto const group = group_->value();
+    auto const document = document_->isChecked();
+    auto const sliced = sliced_->isChecked();
     switch (tool) {
         case tool::Std: {
             auto [grammar, variations] = options_std();
             auto json = glz::write_json(variations);
-            EventController::instance().send_event(event::RunRequest, tool, grammar, qstr::fromStdString(json));
+            EventController::instance().send_event(id, tool, results, limit, group, document, sliced, grammar, qstr::fromStdString(json));
             break;
         }
+        case tool::Qt:
+            EventController::instance().send_event(id, tool, results, limit, group, document, sliced, options_qt());
+            break;
+        case tool::Pcre2:
+            EventController::instance().send_event(id, tool, results, limit, group, document, sliced, options_pcre2());
+            break;
         default: {}
     }
 }
@@ -179,3 +365,33 @@ OptionsWidget::options_std() const noexcept {
 
     return {grammar, variations};
 }
+
+u32 OptionsWidget::options_pcre2() const noexcept {
+#ifdef PCRE2_REGEX
+    // In byte mode every byte is a character.
+    u32 options = bytes_->isChecked() ? 0 : PCRE2_UTF;
+    if (icace_->isChecked()) options |= PCRE2_CASELESS;
+    if (nosubs_->isChecked()) options |= PCRE2_NO_AUTO_CAPTURE;
+    if (multiline_->isChecked()) options |= PCRE2_MULTILINE;
+    return options;
+#else
+    return {};
+#endif
+}
+
+int OptionsWidget::options_qt() const noexcept {
+    QRegularExpression::PatternOptions options = QRegularExpression::NoPatternOption;
+    if (icace_->isChecked()) options |= QRegularExpression::CaseInsensitiveOption;
+    if (nosubs_->isChecked()) options |= QRegularExpression::DontCaptureOption;
+    if (multiline_->isChecked()) options |= QRegularExpression::MultilineOption;
+    return options.toInt();
+}
+
+Granularity OptionsWidget::granularity() const noexcept {
+    if (any_->isChecked()) return Granularity::Any;
+    if (count_->isChecked()) return Granularity::Count;
+    if (offsets_->isChecked()) return Granularity::Offsets;
+    if (on_demand_->isChecked()) return Granularity::OnDemand;
+    if (group_by_->isChecked()) return Granularity::GroupBy;
+    return Granularity::Full;
+}
@@ -32,8 +32,10 @@
 /*------- forward declarations:
 -------------------------------------------------------------------*/
 class QCheckBox;
+class QLineEdit;
 class QPushButton;
 class QRadioButton;
+class QSpinBox;
 
 /*------- class declaration:
 -------------------------------------------------------------------*/
@@ -44,15 +46,42 @@ public:
     ~OptionsWidget() override = default;
     [[nodiscard]] std::pair<type::StdSyntaxOption, std::vector<type::StdSyntaxOption>>
         options_std() const noexcept;
+    /// PCRE2 compile options mapped from grammar variations.
+    [[nodiscard]] u32 options_pcre2() const noexcept;
+    /// QRegularExpression pattern options mapped from grammar variations.
+    [[nodiscard]] int options_qt() const noexcept;
+    /// What the user wants to know about matches.
+    [[nodiscard]] Granularity granularity() const noexcept;
+    /// Send request (run or sample) with all options.
+    void request(int id) const noexcept;
+    /// Replacement for search-and-replace (in the syntax of the tool).
+    [[nodiscard]] qstr replacement() const noexcept;
+    /// Number of replacements shown in the diff preview.
+    [[nodiscard]] isize preview() const noexcept;
+    /// Number of measured runs of every engine in the benchmark.
+    [[nodiscard]] int runs() const noexcept;
+    /// Measurements of runs are also appended to the matches-view.
+    [[nodiscard]] bool metrics() const noexcept;
 
 private slots:
     void run_slot() noexcept;
+    void benchmark_slot() noexcept;
+    void profile_slot() noexcept;
+    void sample_slot() noexcept;
+    void run_all_slot() noexcept;
+    void export_slot() noexcept;
+    void trace_slot(bool checked) noexcept;
+    void replace_slot() noexcept;
+    void replace_tab_slot() noexcept;
     static void claer_all() noexcept {
         EventController::instance().send_event(event::ClearAll);
     }
     static void claer_matches() noexcept {
         EventController::instance().send_event(event::ClearMatches);
     }
+    static void more() noexcept {
+        EventController::instance().send_event(event::MoreRequest);
+    }
 
 private:
     QRadioButton* const std_;
@@ -69,8 +98,32 @@ private:
     QCheckBox* const optimize_;
     QCheckBox* const collate_;
     QCheckBox* const multiline_;
+    QCheckBox* const bytes_;
+    QRadioButton* const any_;
+    QRadioButton* const count_;
+    QRadioButton* const offsets_;
+    QRadioButton* const full_;
+    QRadioButton* const on_demand_;
+    QRadioButton* const group_by_;
+    QSpinBox* const group_;
+    QSpinBox* const limit_;
+    QCheckBox* const document_;
+    QCheckBox* const sliced_;
+    QSpinBox* const runs_;
+    QCheckBox* const metrics_;
+    QLineEdit* const replacement_;
+    QSpinBox* const preview_;
+    QPushButton* const replace_;
+    QPushButton* const replace_tab_;
 
     QPushButton* const run_;
+    QPushButton* const benchmark_;
+    QPushButton* const profile_;
+    QPushButton* const more_;
+    QPushButton* const sample_;
+    QPushButton* const run_all_;
+    QPushButton* const export_;
+    QPushButton* const trace_;
     QPushButton* const clear_all_;
     QPushButton* const clear_matches_;
     QPushButton* const exit_;
@@ -89,8 +142,33 @@ private:
     static char const * const Optimize;
     static char const * const Collate;
     static char const * const Multiline;
+    static char const * const Bytes;
+    static char const * const AnyMatch;
+    static char const * const CountOnly;
+    static char const * const OffsetsOnly;
+    static char const * const FullCaptures;
+    static char const * const OnDemand;
+    static char const * const GroupBy;
+    static char const * const Group;
+    static char const * const StopAfter;
+    static char const * const NoLimit;
+    static char const * const WholeDocument;
+    static char const * const Sliced;
+    static char const * const BenchmarkRuns;
+    static char const * const Metrics;
+    static char const * const ReplaceWith;
+    static char const * const Preview;
+    static char const * const ReplaceToFile;
+    static char const * const ReplaceToTab;
 
     static char const * const Run;
+    static char const * const Benchmark;
+    static char const * const Profile;
+    static char const * const More;
+    static char const * const Sample;
+    static char const * const RunAll;
+    static char const * const Export;
+    static char const * const Trace;
     static char const * const ClearAll;
     static char const * const ClearMatches;
     static char const * const Exit;
@@ -0,0 +1,158 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Profiler.h"
+#include <algorithm>
+#include <fmt/core.h>
+
+/*------- class implementation:
+-------------------------------------------------------------------*/
+Profiler::Profiler(std::vector<Utf16Subject> subjects, qstrings patterns, u32 const options) :
+    subjects_{std::move(subjects)},
+    patterns_{std::move(patterns)},
+    // Callouts before every item of the pattern.
+    options_{options | PCRE2_AUTO_CALLOUT}
+{}
+
+void Profiler::reset(isize) {
+    heat_.clear();
+    rgx_.reset();
+    counts_.clear();
+    pattern_ = 0;
+    subject_ = 0;
+    found_ = 0;
+}
+
+Run::Status Profiler::advance(Sink& sink, Clock::time_point const deadline) {
+    // A source with heavy backtracking takes a long time - the matcher is stopped at the deadline
+    // (the steps and matches until then are counted), the next slice goes on with the next source.
+    // The source is not resumed - PCRE2 can't continue the match, a new one would count its steps again.
+    auto interrupted = false;
+    isize steps{};
+    auto const trace = [this, deadline, &interrupted, &steps](RegexPcre16::Step const& step) {
+        if (++steps % ClockSteps == 0 and Clock::now() >= deadline) {
+            interrupted = true;
+            return false;
+        }
+        if (step.position >= counts_.size())
+            return true;
+        auto& spot = counts_[step.position];
+        spot.length = isize(step.length);
+        ++spot.visits;
+        if (step.backtrack)
+            ++spot.backtracks;
+        return true;
+    };
+
+    for (; pattern_ < int(patterns_.size()); ++pattern_) {
+        // The pattern is started (or continued after the slice).
+        if (int(heat_.size()) == pattern_)
+            compile();
+        auto& heat = heat_.back();
+        while (rgx_ and subject_ < int(subjects_.size())) {
+            if (Clock::now() >= deadline)
+                return Status::Slice;
+            auto const& subject = subjects_[subject_++];
+            std::string error;
+            heat.matches += rgx_->trace(subject.data(), subject.size(), trace, &error);
+            if (interrupted) {
+                ++heat.interrupted;
+                return Status::Slice;
+            }
+            if (not error.empty()) {
+                ++heat.failures;
+                heat.error = std::move(error);
+            }
+        }
+
+        for (auto const& spot : counts_)
+            if (spot.visits) {
+                heat.spots.push_back(spot);
+                heat.visits += spot.visits;
+                heat.backtracks += spot.backtracks;
+            }
+        found_ += heat.matches;
+        report(heat, sink);
+        rgx_.reset();
+        counts_.clear();
+        subject_ = 0;
+    }
+    return Status::Done;
+}
+
+void Profiler::compile() {
+    auto const& pattern = patterns_[pattern_];
+    heat_.push_back(Heat{.pattern = pattern});
+
+    auto const data = reinterpret_cast<char16_t const*>(pattern.utf16());
+    auto const n = std::size_t(pattern.size());
+    auto rgx = std::make_unique<RegexPcre16 const>(data, n, options_);
+    if (not rgx->valid()) {
+        heat_.back().error = rgx->error();
+        return;
+    }
+    rgx_ = std::move(rgx);
+    // The last position is the end of the pattern.
+    counts_.assign(n + 1, {});
+    for (std::size_t i = 0; i < counts_.size(); ++i)
+        counts_[i].position = isize(i);
+}
+
+void Profiler::report(Heat const& heat, Sink& sink) const {
+    auto const pattern = heat.pattern.toStdString();
+    if (heat.spots.empty() and not heat.error.empty()) {
+        sink.line(fmt::format("=== profile of '{}' ===", pattern));
+        sink.line(fmt::format("ERROR: {}", heat.error));
+        return;
+    }
+    // Totals are partial if the matcher was stopped on some lines.
+    auto const partial = heat.interrupted
+            ? fmt::format(" (partial - {} lines stopped at the end of a time slice)", heat.interrupted)
+            : std::string{};
+    sink.line(fmt::format("=== profile of '{}': {} steps, {} after backtracking, {} matches in {} lines{} ===",
+                          pattern, heat.visits, heat.backtracks, heat.matches, subjects_.size(), partial));
+    if (heat.failures)
+        sink.line(fmt::format("the matcher gave up on {} lines: {}", heat.failures, heat.error));
+
+    // The hottest spots are the ones the matcher keeps coming back to.
+    auto spots = heat.spots;
+    std::ranges::sort(spots, [](Spot const& a, Spot const& b) {
+        return a.backtracks not_eq b.backtracks ? a.backtracks > b.backtracks : a.visits > b.visits;
+    });
+    if (spots.size() > TopCount)
+        spots.resize(TopCount);
+    if (spots.empty())
+        return;
+    sink.line(fmt::format("{:>12} {:>12} {:>7}  item", "visits", "backtracks", "share"));
+    for (auto const& spot : spots) {
+        auto const share = heat.visits ? 100.0 * double(spot.visits) / double(heat.visits) : 0.0;
+        auto const item = spot.length
+                ? heat.pattern.mid(spot.position, spot.length).toStdString()
+                : std::string{"<end>"};
+        sink.line(fmt::format("{:>12} {:>12} {:>6.1f}%  {}: '{}'",
+                              spot.visits, spot.backtracks, share, spot.position, item));
+    }
+}
@@ -0,0 +1,103 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include "Search.h"
+#include "Subject.h"
+#include "RegexPcre.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// Profile of backtracking - patterns are compiled with PCRE2_AUTO_CALLOUT and every step
+/// of the matcher is counted at its item of the pattern (visits and visits after a backtrack). \n
+/// Runs in time slices on the scheduler like any other run. The report (hot spots of every pattern)
+/// goes to the sink at the end, the heat of items can be drawn over the patterns.
+class Profiler : public Run {
+public:
+    /// Counts of one item of the pattern.
+    struct Spot {
+        isize position{};       // offset of the item in the pattern (QString positions)
+        isize length{};         // length of the item
+        isize visits{};
+        isize backtracks{};     // visits after a backtrack
+    };
+    /// Profile of one pattern.
+    struct Heat {
+        qstr pattern{};
+        std::vector<Spot> spots{};  // visited items, in the order of the pattern
+        isize visits{};
+        isize backtracks{};
+        isize matches{};
+        isize failures{};       // sources on which the matcher gave up (match limit)
+        isize interrupted{};    // sources stopped at the end of a time slice (steps until then are counted)
+        std::string error{};    // the pattern can't be compiled or the last failure
+    };
+
+    /// \param subjects - the sources,
+    /// \param patterns - the profiled patterns,
+    /// \param options - PCRE2 compile options (PCRE2_AUTO_CALLOUT is added).
+    Profiler(std::vector<Utf16Subject> subjects, qstrings patterns, u32 options);
+
+    void reset(isize limit) override;
+    void next_page() override {}
+    Status advance(Sink& sink, Clock::time_point deadline) override;
+    /// Profiles are not sampled.
+    void sample(Sink&, isize) override {}
+    [[nodiscard]] strings groups(int) const override {
+        return {};
+    }
+    [[nodiscard]] isize found() const noexcept override {
+        return found_;
+    }
+
+    /// Profiles of patterns scanned so far.
+    [[nodiscard]] std::vector<Heat> const& heat() const noexcept {
+        return heat_;
+    }
+
+private:
+    /// Compile the current pattern (the heat gets the error if it can't be compiled).
+    void compile();
+    /// Hot spots of the finished pattern.
+    void report(Heat const& heat, Sink& sink) const;
+
+    std::vector<Utf16Subject> const subjects_;
+    qstrings const patterns_;
+    u32 const options_;
+    std::vector<Heat> heat_{};
+    std::unique_ptr<RegexPcre16 const> rgx_{};
+    std::vector<Spot> counts_{};    // counts of the current pattern (indexed by position)
+    int pattern_{};
+    int subject_{};
+    isize found_{};
+    static constexpr std::size_t TopCount = 10;
+    /// The clock is read once per so many steps (a step is much cheaper than reading the clock).
+    static constexpr isize ClockSteps = 1024;
+};
@@ -27,150 +27,305 @@
 -------------------------------------------------------------------*/
 #include "RegexPcre.h"
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <fmt/core.h>
 
-using std::cout;
 using std::cerr;
 
 // Creates PcreRegex object.
-RegexPcre::RegexPcre(char const *const pattern, char const *const subject, u32 const n) {
-    pattern_ = (PCRE2_SPTR8) pattern;
-    subject_ = (PCRE2_SPTR8) subject;
-    size_ = (PCRE2_SIZE) n;
-
-    int errno;
+template<typename CharT>
+BasicRegexPcre<CharT>::BasicRegexPcre(CharT const *const pattern, std::size_t const n, u32 const options) {
+    int error_code;
     PCRE2_SIZE offset;
-    if (re_ = pcre2_compile_8(pattern_, PCRE2_ZERO_TERMINATED, PCRE2_UTF, &errno, &offset, nullptr); re_ == nullptr) {
-        PCRE2_UCHAR buffer[128];
-        pcre2_get_error_message(errno, buffer, sizeof(buffer));
-        cerr << "RegexPcre: compilation failed at offset " << offset << ": " << buffer << '\n';
+    if (re_ = api::compile(reinterpret_cast<sptr>(pattern), n, options, &error_code, &offset); re_ == nullptr) {
+        error_ = fmt::format("compilation failed at offset {}: {}", offset, api::error_message(error_code));
+        cerr << "RegexPcre: " << error_ << '\n';
+        return;
     }
-    match_data_ = pcre2_match_data_create_from_pattern_8(re_, nullptr);
+
+    u32 option_bits{};
+    api::info(re_, PCRE2_INFO_ALLOPTIONS, &option_bits);
+    utf_ = (option_bits & PCRE2_UTF) not_eq 0;
+
+    u32 newline{};
+    api::info(re_, PCRE2_INFO_NEWLINE, &newline);
+    crlf_ = newline == PCRE2_NEWLINE_ANY or
+            newline == PCRE2_NEWLINE_CRLF or
+            newline == PCRE2_NEWLINE_ANYCRLF;
 }
 
-// Searches first match or all if needed.
-std::vector<RegexPcre::Match> RegexPcre::run(bool const find_all) const noexcept {
-    auto rc = pcre2_match(re_, subject_, size_, 0, 0, match_data_, nullptr);
-    if (rc < 0) {
-        if (rc == PCRE2_ERROR_NOMATCH) {
-            cout << "RegexPcre: match not found\n";
-            return {};
-        }
-        PCRE2_UCHAR buffer[128];
-        pcre2_get_error_message(rc, buffer, sizeof(buffer));
-        cerr << "RegexPcre: " << buffer << '\n';
-        return {};
-    }
+template<typename CharT>
+BasicRegexPcre<CharT>::~BasicRegexPcre() {
+    for (auto const md : pool_)
+        api::free(md);
+    if (re_) api::free(re_);
+}
 
-    auto ovector = pcre2_get_ovector_pointer(match_data_);
+template<typename CharT>
+bool BasicRegexPcre<CharT>::jit() noexcept {
+    if (valid() and not jit_)
+        jit_ = api::jit_compile(re_) == 0;
+    return jit_;
+}
 
-    uint32_t option_bits{};
-    pcre2_pattern_info(re_, PCRE2_INFO_ALLOPTIONS, &option_bits);
-    auto is_utf8 = (option_bits & PCRE2_UTF) != 0;
-    if (is_utf8)
-        ovector[1] = update_utf8_size(ovector[1]);
+template<typename CharT>
+std::size_t BasicRegexPcre<CharT>::code_size() const noexcept {
+    std::size_t size{};
+    if (valid())
+        api::info(re_, PCRE2_INFO_SIZE, &size);
+    return size;
+}
 
-    std::vector<Match> matches{};
-    u32 const pos = ovector[0];
-    u32 const length = ovector[1] - ovector[0];
-    matches.push_back(Match{.offset = pos, .size = length});
+template<typename CharT>
+std::size_t BasicRegexPcre<CharT>::jit_size() const noexcept {
+    std::size_t size{};
+    if (jit_)
+        api::info(re_, PCRE2_INFO_JITSIZE, &size);
+    return size;
+}
 
-    if (not find_all) {
-        pcre2_match_data_free(match_data_);
-        pcre2_code_free(re_);
-        matches.shrink_to_fit();
-        return matches;
-    }
+// Searches all matches, one by one.
+template<typename CharT>
+Generator<typename BasicRegexPcre<CharT>::Hit>
+BasicRegexPcre<CharT>::matches(CharT const *const subject, std::size_t const n, std::size_t const start) const {
+    return search(subject, n, start, nullptr, nullptr);
+}
 
-    auto rest_matches = rest(ovector);
-    if (not rest_matches.empty())
-        std::copy(rest_matches.cbegin(), rest_matches.cend(), std::back_inserter(matches));
+template<typename CharT>
+isize BasicRegexPcre<CharT>::trace(CharT const *const subject, std::size_t const n,
+                                   Trace const& trace, std::string* const error) const {
+    using callout_block = typename api::callout_block;
+    std::unique_ptr<match_context, void (*)(match_context*)> const context{
+            api::create_match_context(),
+            [](match_context* const mc) { api::free(mc); }};
+    if (not context)
+        return 0;
+    // Zero - the matcher goes on, negative - the match fails with the error.
+    api::set_callout(context.get(), [](callout_block* const block, void* const data) {
+        auto const go_on = (*static_cast<Trace const*>(data))(Step{
+            .position = block->pattern_position,
+            .length = block->next_item_length,
+            .current = block->current_position,
+            .backtrack = (block->callout_flags & PCRE2_CALLOUT_BACKTRACK) not_eq 0});
+        return go_on ? 0 : PCRE2_ERROR_CALLOUT;
+    }, const_cast<Trace*>(&trace));
 
-    pcre2_match_data_free(match_data_);
-    pcre2_code_free(re_);
-    matches.shrink_to_fit();
-    return matches;
+    isize count{};
+    for ([[maybe_unused]] auto const& hit : search(subject, n, 0, context.get(), error))
+        ++count;
+    return count;
 }
 
-// Searches all next matches.
-std::vector<RegexPcre::Match> RegexPcre::rest(PCRE2_SIZE *ovector) const noexcept {
-    u32 option_bits{};
-    pcre2_pattern_info(re_, PCRE2_INFO_ALLOPTIONS, &option_bits);
-    auto is_utf8 = (option_bits & PCRE2_UTF) not_eq 0;
+template<typename CharT>
+Generator<typename BasicRegexPcre<CharT>::Hit>
+BasicRegexPcre<CharT>::search(CharT const *const subject, std::size_t const n, std::size_t const start,
+                              match_context* const context, std::string* const error) const {
+    if (not valid())
+        co_return;
 
-    u32 newline{};
-    pcre2_pattern_info(re_, PCRE2_INFO_NEWLINE, &newline);
-    bool is_crlf_newline =
-            newline == PCRE2_NEWLINE_ANY or
-            newline == PCRE2_NEWLINE_CRLF or
-            newline == PCRE2_NEWLINE_ANYCRLF;
+    // Match data goes back to the pool when the generator is finished or destroyed.
+    Lease const lease{this, acquire()};
+    if (not lease.md) {
+        if (error)
+            *error = api::error_message(PCRE2_ERROR_NOMEMORY);
+        else
+            cerr << "RegexPcre: " << api::error_message(PCRE2_ERROR_NOMEMORY) << '\n';
+        co_return;
+    }
 
-    std::vector<Match> matches{};
+    auto const s = reinterpret_cast<sptr>(subject);
+    auto const ovector = api::ovector(lease.md);
+    // The subject is checked for valid UTF only once, in the first call.
+    u32 const no_check = utf_ ? PCRE2_NO_UTF_CHECK : 0;
 
+    PCRE2_SIZE offset = start;
+    u32 options{};
+    bool first = true;
     for (;;) {
-        u32 options{};
-        auto start_offset = ovector[1];
+        auto const flags = first ? options : options | no_check;
+        auto rc = api::match(re_, s, n, offset, flags, lease.md, context);
+        if (rc == PCRE2_ERROR_JIT_STACKLIMIT)
+            // The machine stack of the JIT is small, the interpreter uses the heap.
+            rc = api::match(re_, s, n, offset, flags | PCRE2_NO_JIT, lease.md, context);
+        first = false;
+        if (rc == PCRE2_ERROR_NOMATCH) {
+            if (options == 0)
+                co_return;
+            // There is no non-empty match at the place of the last empty match,
+            // advance one character and search normally.
+            offset = advance(s, n, offset, crlf_);
+            options = 0;
+            continue;
+        }
+        if (rc < 0) {
+            if (error)
+                *error = api::error_message(rc);
+            else
+                cerr << "RegexPcre: " << api::error_message(rc) << '\n';
+            co_return;
+        }
+
+        co_yield Hit{ovector, rc};
 
+        options = 0;
+        offset = ovector[1];
         if (ovector[0] == ovector[1]) {
-            if (ovector[0] == size_)
-                break;
+            // Empty match - next one must not be empty at the same place.
+            if (ovector[0] == n)
+                co_return;
             options = PCRE2_NOTEMPTY_ATSTART | PCRE2_ANCHORED;
         }
-        else {
-            PCRE2_SIZE startchar = pcre2_get_startchar(match_data_);
-            if (start_offset <= startchar) {
-                if (startchar >= size_)
-                    break;
-                start_offset = startchar + 1;
-                if (is_utf8)
-                    for ( ; start_offset < size_; start_offset++)
-                        if ((subject_[start_offset] & 0xc0) != 0x80)
-                            break;
-            }
+        else if (auto const startchar = api::startchar(lease.md); offset <= startchar) {
+            // \K in lookbehind moved the start of the match behind its end.
+            if (startchar >= n)
+                co_return;
+            offset = advance(s, n, startchar, false);
         }
+    }
+}
 
-        // Run the next matching operation
-        auto rc = pcre2_match(re_, subject_, size_, start_offset, options, match_data_, nullptr);
-        if (rc == PCRE2_ERROR_NOMATCH) {
-            if (options == 0)
-                break;
-            ovector[1] = start_offset + 1;
-            if (is_crlf_newline and start_offset < size_ - 1 and subject_[start_offset == '\r' and subject_[start_offset + 1] == '\n'])
-                ovector[1] += 1;
-            else if (is_utf8) {
-                while (ovector[1] < size_) {
-                    if ((subject_[ovector[1]] & 0xc0) not_eq 0x80)
-                        break;
-                    ovector[1] += 1;
-                }
-            }
+// Searches all matches with the DFA, one by one.
+template<typename CharT>
+Generator<typename BasicRegexPcre<CharT>::Hit>
+BasicRegexPcre<CharT>::dfa_matches(CharT const *const subject, std::size_t const n, std::string* const error) const {
+    if (not valid())
+        co_return;
+
+    Lease const lease{this, acquire()};
+    if (not lease.md) {
+        if (error) *error = api::error_message(PCRE2_ERROR_NOMEMORY);
+        co_return;
+    }
+
+    auto const s = reinterpret_cast<sptr>(subject);
+    auto const ovector = api::ovector(lease.md);
+    u32 const no_check = utf_ ? PCRE2_NO_UTF_CHECK : 0;
+    // Recommended size, it grows if a pattern needs more.
+    std::vector<int> workspace(1000);
+
+    PCRE2_SIZE offset{};
+    bool first = true;
+    for (;;) {
+        auto const rc = api::dfa_match(re_, s, n, offset, first ? 0 : no_check, lease.md,
+                                       workspace.data(), workspace.size());
+        if (rc == PCRE2_ERROR_DFA_WSSIZE) {
+            workspace.resize(workspace.size() * 2);
             continue;
         }
+        first = false;
+        if (rc == PCRE2_ERROR_NOMATCH)
+            co_return;
+        if (rc < 0) {
+            if (error) *error = api::error_message(rc);
+            co_return;
+        }
 
-        if (rc < 0)
-            return {};
-
-        if (is_utf8)
-            ovector[1] = update_utf8_size(ovector[1]);
+        // Longest match is the first one (rc == 0 means that the rest did not fit into the ovector).
+        co_yield Hit{ovector, 1};
 
-        u32 const pos = ovector[0];
-        u32 const length = ovector[1] - ovector[0];
-        matches.push_back(Match{.offset =  pos, .size =  length});
+        if (ovector[0] == n)
+            co_return;
+        // DFA has no PCRE2_NOTEMPTY_ATSTART, an empty match just moves on by one character.
+        offset = ovector[0] == ovector[1] ? advance(s, n, ovector[1], crlf_) : ovector[1];
     }
-    matches.shrink_to_fit();
-    return matches;
 }
 
-PCRE2_SIZE RegexPcre::update_utf8_size(PCRE2_SIZE ovector) const noexcept {
-    u8 const c = subject_[ovector];
+// Anchored match at the offset.
+template<typename CharT>
+Spans BasicRegexPcre<CharT>::groups_at(CharT const *const subject, std::size_t const n, std::size_t const offset) const noexcept {
+    if (not valid())
+        return {};
 
-    int n{};
-    if (c == 0xc5 or c == 0xc4 or c == 0xc3) n = 2;
+    Lease const lease{this, acquire()};
+    if (not lease.md)
+        return {};
+    auto const s = reinterpret_cast<sptr>(subject);
+    auto rc = api::match(re_, s, n, offset, PCRE2_ANCHORED, lease.md);
+    if (rc == PCRE2_ERROR_JIT_STACKLIMIT)
+        // The same fallback as the scan - the match it reported must be found again.
+        rc = api::match(re_, s, n, offset, PCRE2_ANCHORED | PCRE2_NO_JIT, lease.md);
+    if (rc < 0)
+        return {};
+
+    auto const ovector = api::ovector(lease.md);
+    Hit const hit{ovector, rc};
+    Spans spans;
+    spans.reserve(rc);
+    for (int i = 0; i < rc; ++i)
+        spans.push_back(Span{.start = hit.start(i), .length = hit.length(i)});
+    return spans;
+}
 
-    if (n not_eq  0)
-        while (ovector < size_ and n > 0) {
-            ++ovector;
-            --n;
+template<typename CharT>
+isize BasicRegexPcre<CharT>::replace(CharT const* const subject, std::size_t const n,
+                                     CharT const* const replacement, std::size_t const rn,
+                                     std::basic_string<CharT>& out) const
+{
+    if (not valid()) {
+        out.append(subject, n);
+        return 0;
+    }
+    static constexpr u32 options = PCRE2_SUBSTITUTE_GLOBAL | PCRE2_SUBSTITUTE_OVERFLOW_LENGTH;
+    Lease const lease{this, acquire()};
+    if (not lease.md)
+        throw std::runtime_error(api::error_message(PCRE2_ERROR_NOMEMORY));
+    auto const base = out.size();
+    // Usually enough at once, otherwise PCRE2 tells the exact size (with the trailing zero).
+    auto room = PCRE2_SIZE(n + n / 2 + rn + 1);
+    for (;;) {
+        out.resize(base + room);
+        auto size = room;
+        auto const rc = api::substitute(re_, reinterpret_cast<sptr>(subject), n, options, lease.md,
+                                        reinterpret_cast<sptr>(replacement), rn,
+                                        reinterpret_cast<typename api::uchar*>(out.data() + base), &size);
+        if (rc == PCRE2_ERROR_NOMEMORY and size > room) {
+            room = size;
+            continue;
+        }
+        if (rc < 0) {
+            out.resize(base);
+            throw std::runtime_error(api::error_message(rc));
+        }
+        out.resize(base + size);
+        return rc;
+    }
+}
+
+// Offset of the next character.
+template<typename CharT>
+PCRE2_SIZE BasicRegexPcre<CharT>::advance(sptr const subject, PCRE2_SIZE const n, PCRE2_SIZE offset, bool const crlf) const noexcept {
+    if (crlf and offset + 1 < n and subject[offset] == '\r' and subject[offset + 1] == '\n')
+        return offset + 2;
+    ++offset;
+    if (utf_)
+        while (offset < n and api::is_continuation(CharT(subject[offset])))
+            ++offset;
+    return offset;
+}
+
+template<typename CharT>
+typename BasicRegexPcre<CharT>::match_data* BasicRegexPcre<CharT>::acquire() const noexcept {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (not pool_.empty()) {
+            auto const md = pool_.back();
+            pool_.pop_back();
+            return md;
         }
+    }
+    return api::create_match_data(re_);
+}
 
-    return ovector;
+template<typename CharT>
+void BasicRegexPcre<CharT>::release(match_data* const md) const noexcept {
+    if (not md)
+        return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    pool_.push_back(md);
 }
+
+/*------- explicit instantiations:
+-------------------------------------------------------------------*/
+template class BasicRegexPcre<char>;
+template class BasicRegexPcre<char16_t>;
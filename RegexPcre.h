@@ -28,31 +28,280 @@
 /*------- include files:
 -------------------------------------------------------------------*/
 #include "Types.h"
-#define PCRE2_CODE_UNIT_WIDTH 8
+#include "Generator.h"
+// Width 0 - we use explicitly both the 8-bit and the 16-bit library.
+#define PCRE2_CODE_UNIT_WIDTH 0
 #include <pcre2.h>
+#include <functional>
+#include <mutex>
+#include <string>
 #include <vector>
 
+/*------- PCRE2 functions for the code unit width:
+-------------------------------------------------------------------*/
+namespace pcre {
+    template<typename CharT>
+    struct Api;
+
+    /// 8-bit library - subject is UTF-8 (or raw bytes).
+    template<>
+    struct Api<char> {
+        using sptr = PCRE2_SPTR8;
+        using code = pcre2_code_8;
+        using match_data = pcre2_match_data_8;
+        using match_context = pcre2_match_context_8;
+        using callout_block = pcre2_callout_block_8;
+        using uchar = PCRE2_UCHAR8;
+
+        static code* compile(sptr pattern, PCRE2_SIZE n, u32 options, int* error, PCRE2_SIZE* offset) noexcept {
+            return pcre2_compile_8(pattern, n, options, error, offset, nullptr);
+        }
+        static match_data* create_match_data(code const* re) noexcept {
+            return pcre2_match_data_create_from_pattern_8(re, nullptr);
+        }
+        static int match(code const* re, sptr subject, PCRE2_SIZE n, PCRE2_SIZE start, u32 options, match_data* md,
+                         match_context* mc = nullptr) noexcept {
+            return pcre2_match_8(re, subject, n, start, options, md, mc);
+        }
+        static match_context* create_match_context() noexcept {
+            return pcre2_match_context_create_8(nullptr);
+        }
+        static void set_callout(match_context* mc, int (*callout)(callout_block*, void*), void* data) noexcept {
+            pcre2_set_callout_8(mc, callout, data);
+        }
+        static int substitute(code const* re, sptr subject, PCRE2_SIZE n, u32 options, match_data* md,
+                              sptr replacement, PCRE2_SIZE rn, uchar* out, PCRE2_SIZE* out_n) noexcept {
+            return pcre2_substitute_8(re, subject, n, 0, options, md, nullptr, replacement, rn, out, out_n);
+        }
+        static int dfa_match(code const* re, sptr subject, PCRE2_SIZE n, PCRE2_SIZE start, u32 options, match_data* md,
+                             int* workspace, PCRE2_SIZE wn) noexcept {
+            return pcre2_dfa_match_8(re, subject, n, start, options, md, nullptr, workspace, wn);
+        }
+        static int jit_compile(code* re) noexcept {
+            return pcre2_jit_compile_8(re, PCRE2_JIT_COMPLETE);
+        }
+        static PCRE2_SIZE* ovector(match_data* md) noexcept {
+            return pcre2_get_ovector_pointer_8(md);
+        }
+        static PCRE2_SIZE startchar(match_data* md) noexcept {
+            return pcre2_get_startchar_8(md);
+        }
+        static int info(code const* re, u32 what, void* where) noexcept {
+            return pcre2_pattern_info_8(re, what, where);
+        }
+        static void free(code* re) noexcept { pcre2_code_free_8(re); }
+        static void free(match_data* md) noexcept { pcre2_match_data_free_8(md); }
+        static void free(match_context* mc) noexcept { pcre2_match_context_free_8(mc); }
+
+        static std::string error_message(int const error) noexcept {
+            PCRE2_UCHAR8 buffer[256];
+            pcre2_get_error_message_8(error, buffer, sizeof(buffer));
+            return reinterpret_cast<char const*>(buffer);
+        }
+        /// Checks if the code unit is not the first unit of a character.
+        static bool is_continuation(char const c) noexcept {
+            return (u8(c) & 0xc0) == 0x80;
+        }
+    };
+
+    /// 16-bit library - subject is UTF-16 (QString data, without transcoding).
+    template<>
+    struct Api<char16_t> {
+        using sptr = PCRE2_SPTR16;
+        using code = pcre2_code_16;
+        using match_data = pcre2_match_data_16;
+        using match_context = pcre2_match_context_16;
+        using callout_block = pcre2_callout_block_16;
+        using uchar = PCRE2_UCHAR16;
+
+        static code* compile(sptr pattern, PCRE2_SIZE n, u32 options, int* error, PCRE2_SIZE* offset) noexcept {
+            return pcre2_compile_16(pattern, n, options, error, offset, nullptr);
+        }
+        static match_data* create_match_data(code const* re) noexcept {
+            return pcre2_match_data_create_from_pattern_16(re, nullptr);
+        }
+        static int match(code const* re, sptr subject, PCRE2_SIZE n, PCRE2_SIZE start, u32 options, match_data* md,
+                         match_context* mc = nullptr) noexcept {
+            return pcre2_match_16(re, subject, n, start, options, md, mc);
+        }
+        static match_context* create_match_context() noexcept {
+            return pcre2_match_context_create_16(nullptr);
+        }
+        static void set_callout(match_context* mc, int (*callout)(callout_block*, void*), void* data) noexcept {
+            pcre2_set_callout_16(mc, callout, data);
+        }
+        static int substitute(code const* re, sptr subject, PCRE2_SIZE n, u32 options, match_data* md,
+                              sptr replacement, PCRE2_SIZE rn, uchar* out, PCRE2_SIZE* out_n) noexcept {
+            return pcre2_substitute_16(re, subject, n, 0, options, md, nullptr, replacement, rn, out, out_n);
+        }
+        static int dfa_match(code const* re, sptr subject, PCRE2_SIZE n, PCRE2_SIZE start, u32 options, match_data* md,
+                             int* workspace, PCRE2_SIZE wn) noexcept {
+            return pcre2_dfa_match_16(re, subject, n, start, options, md, nullptr, workspace, wn);
+        }
+        static int jit_compile(code* re) noexcept {
+            return pcre2_jit_compile_16(re, PCRE2_JIT_COMPLETE);
+        }
+        static PCRE2_SIZE* ovector(match_data* md) noexcept {
+            return pcre2_get_ovector_pointer_16(md);
+        }
+        static PCRE2_SIZE startchar(match_data* md) noexcept {
+            return pcre2_get_startchar_16(md);
+        }
+        static int info(code const* re, u32 what, void* where) noexcept {
+            return pcre2_pattern_info_16(re, what, where);
+        }
+        static void free(code* re) noexcept { pcre2_code_free_16(re); }
+        static void free(match_data* md) noexcept { pcre2_match_data_free_16(md); }
+        static void free(match_context* mc) noexcept { pcre2_match_context_free_16(mc); }
+
+        static std::string error_message(int const error) noexcept {
+            PCRE2_UCHAR16 buffer[256];
+            pcre2_get_error_message_16(error, buffer, sizeof(buffer) / sizeof(PCRE2_UCHAR16));
+            // PCRE2 messages are plain ASCII.
+            std::string text;
+            for (auto it = buffer; *it; ++it)
+                text.push_back(char(*it));
+            return text;
+        }
+        /// Checks if the code unit is a low surrogate (second unit of a pair).
+        static bool is_continuation(char16_t const c) noexcept {
+            return (c & 0xfc00) == 0xdc00;
+        }
+    };
+}
+
 /*------- include class:
 -------------------------------------------------------------------*/
-class RegexPcre {
-    PCRE2_SPTR8 pattern_;
-    PCRE2_SPTR8 subject_;
-    PCRE2_SIZE size_;
-    pcre2_code* re_;
-    pcre2_match_data *match_data_;
+/// Compiled PCRE2 expression, reusable for any number of subjects. \n
+/// Match data blocks are pooled - they are created once and reused by next searches.
+template<typename CharT>
+class BasicRegexPcre {
+    using api = pcre::Api<CharT>;
+    using sptr = typename api::sptr;
+    using match_data = typename api::match_data;
+    using match_context = typename api::match_context;
+
+    typename api::code* re_{};
+    std::string error_{};
+    bool utf_{};
+    bool crlf_{};
+    bool jit_{};
+    mutable std::mutex mutex_{};
+    mutable std::vector<match_data*> pool_{};
 public:
-    struct Match {
-        u32 offset, size;
+    /// One match (view of the ovector, valid until the next match is requested). \n
+    /// Positions are in code units (bytes for 8-bit, UTF-16 units for 16-bit).
+    struct Hit {
+        PCRE2_SIZE const* ovector;
+        int count;
+
+        [[nodiscard]] int groups() const noexcept {
+            return count;
+        }
+        /// Start of the group or -1 if the group did not participate in the match.
+        [[nodiscard]] isize start(int const i) const noexcept {
+            return ovector[2 * i] == PCRE2_UNSET ? -1 : isize(ovector[2 * i]);
+        }
+        [[nodiscard]] isize length(int const i) const noexcept {
+            return ovector[2 * i] == PCRE2_UNSET ? 0 : isize(ovector[2 * i + 1] - ovector[2 * i]);
+        }
     };
 
-    RegexPcre(char const* pattern, char const* subject, u32 n);
+    /// Compiles the pattern.
+    /// \param pattern - the pattern to compile,
+    /// \param n - number of code units in the pattern,
+    /// \param options - PCRE2 compile options.
+    BasicRegexPcre(CharT const* pattern, std::size_t n, u32 options = PCRE2_UTF);
+    ~BasicRegexPcre();
+    BasicRegexPcre(BasicRegexPcre const&) = delete;
+    BasicRegexPcre& operator=(BasicRegexPcre const&) = delete;
+
+    /// Checks if the pattern was compiled successfully.
+    [[nodiscard]] bool valid() const noexcept {
+        return re_ not_eq nullptr;
+    }
+    /// Compilation error message (empty if valid).
+    [[nodiscard]] std::string const& error() const noexcept {
+        return error_;
+    }
 
-    /// Searches first match or all if needed.
-    /// \param find_all - a flag specifying whether the user wants to find all occurrences matching the pattern
-    /// \return vektor of matches occurences (see item_t).
-    [[nodiscard]] std::vector<Match> run(bool find_all = false) const noexcept;
+    /// Compiles the pattern to machine code, next matches() use it. \n
+    /// Must be called before the expression is shared between threads.
+    /// \return false if JIT is not available (matches() keep using the interpreter).
+    bool jit() noexcept;
+    /// Checks if matches() run the JIT-compiled code.
+    [[nodiscard]] bool jitted() const noexcept {
+        return jit_;
+    }
+
+    /// Size of the compiled pattern in bytes (PCRE2_INFO_SIZE).
+    [[nodiscard]] std::size_t code_size() const noexcept;
+    /// Size of the JIT-compiled machine code in bytes (0 - not JIT-compiled).
+    [[nodiscard]] std::size_t jit_size() const noexcept;
+
+    /// Searches matches in the subject lazily (next match is searched when requested). \n
+    /// The expression must outlive the returned generator.
+    /// \param subject - the text to search (need not be zero terminated, may contain NULs),
+    /// \param n - number of code units in the subject,
+    /// \param start - offset where the search starts.
+    [[nodiscard]] Generator<Hit> matches(CharT const* subject, std::size_t n, std::size_t start = 0) const;
+
+    /// Searches matches with the DFA algorithm (pcre2_dfa_match) - no backtracking, the longest
+    /// match at each position, without captures (hits have only group 0). \n
+    /// Back references and some other items are not supported, the generator ends with an error then.
+    /// \param error - set to the message if the matching has failed (may be null).
+    [[nodiscard]] Generator<Hit> dfa_matches(CharT const* subject, std::size_t n, std::string* error = nullptr) const;
+
+    /// Step of the matcher - the item of the pattern it is going to match (automatic callout).
+    struct Step {
+        std::size_t position;   // offset of the item in the pattern (code units)
+        std::size_t length;     // length of the item (0 - the end of the pattern)
+        std::size_t current;    // offset in the subject
+        bool backtrack;         // the matcher came here after a backtrack
+    };
+    /// Visitor of steps, called for every step of the matcher.
+    /// Returns false to stop the matcher (the search ends as failed).
+    using Trace = std::function<bool(Step const&)>;
+
+    /// Searches all matches (as matches()) and reports every step of the matcher. \n
+    /// The pattern must be compiled with PCRE2_AUTO_CALLOUT (without JIT steps are not reported).
+    /// \param trace - visitor of steps,
+    /// \param error - set to the message if the matching has failed, e.g. the match limit (may be null),
+    /// \return number of matches.
+    isize trace(CharT const* subject, std::size_t n, Trace const& trace, std::string* error = nullptr) const;
+
+    /// Groups of the match that starts exactly at the offset (anchored match).
+    /// \return spans of all groups or empty if there is no match at the offset.
+    [[nodiscard]] Spans groups_at(CharT const* subject, std::size_t n, std::size_t offset) const noexcept;
+
+    /// Replaces all matches in the subject (pcre2_substitute with PCRE2_SUBSTITUTE_GLOBAL).
+    /// \param replacement - replacement ($0, $1, ${name}, $$...) and its length in code units,
+    /// \param out - the result is appended here,
+    /// \return number of replacements.
+    /// \throws std::runtime_error if the replacement is invalid (e.g. unknown group) or there is no memory.
+    isize replace(CharT const* subject, std::size_t n,
+                  CharT const* replacement, std::size_t rn,
+                  std::basic_string<CharT>& out) const;
 
 private:
-    std::vector<Match> rest(PCRE2_SIZE *ovector) const noexcept;
-    PCRE2_SIZE update_utf8_size(PCRE2_SIZE ovector) const noexcept;
+    /// Match data borrowed from the pool (goes back when the lease is destroyed).
+    struct Lease {
+        BasicRegexPcre const* owner;
+        match_data* md;
+        ~Lease() { owner->release(md); }
+    };
+
+    /// Searches matches with the match context (callouts) - matches() without the context. \n
+    /// Errors of matching go to the error (if not null) or to stderr.
+    [[nodiscard]] Generator<Hit> search(CharT const* subject, std::size_t n, std::size_t start,
+                                        match_context* context, std::string* error) const;
+
+    /// \return match data from the pool or a new one (nullptr if there is no memory).
+    match_data* acquire() const noexcept;
+    /// Match data back to the pool (null is ignored).
+    void release(match_data* md) const noexcept;
+    [[nodiscard]] PCRE2_SIZE advance(sptr subject, PCRE2_SIZE n, PCRE2_SIZE offset, bool crlf) const noexcept;
 };
+
+using RegexPcre = BasicRegexPcre<char>;
+using RegexPcre16 = BasicRegexPcre<char16_t>;
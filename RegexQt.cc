@@ -0,0 +1,129 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "RegexQt.h"
+#include <QHash>
+#include <mutex>
+#include <vector>
+
+RegexQt::RegexQt(qstr const& pattern, QRegularExpression::PatternOptions const options) :
+    re_{pattern, options}
+{
+    // Compile (with JIT) now, not with the first match.
+    re_.optimize();
+}
+
+Generator<RegexQt::Hit> RegexQt::matches(qstr const& subject) const {
+    // QRegularExpression is implicitly shared - the copy keeps the compiled pattern alive.
+    auto const re = re_;
+    for (auto it = re.globalMatch(subject); it.hasNext(); ) {
+        auto const match = it.next();
+        co_yield Hit{&match};
+    }
+}
+
+Spans RegexQt::groups_at(qstr const& subject, isize const offset) const noexcept {
+    auto const match = re_.match(subject, offset, QRegularExpression::NormalMatch,
+                                 QRegularExpression::AnchorAtOffsetMatchOption);
+    if (not match.hasMatch())
+        return {};
+
+    Hit const hit{&match};
+    Spans spans;
+    spans.reserve(hit.groups());
+    for (int i = 0; i < hit.groups(); ++i)
+        spans.push_back(Span{.start = hit.start(i), .length = hit.length(i)});
+    return spans;
+}
+
+RegexQt RegexQt::cached(qstr const& pattern, QRegularExpression::PatternOptions const options, bool* const hit) noexcept {
+    static std::mutex mutex;
+    static qhash<qstr, RegexQt> cache;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto const key = qstr::number(options.toInt()) + QChar(0x1f) + pattern;
+    auto const it = cache.constFind(key);
+    if (hit)
+        *hit = it not_eq cache.cend();
+    if (it not_eq cache.cend())
+        return it.value();
+
+    if (cache.size() >= CacheLimit)
+        cache.clear();
+    return cache.insert(key, RegexQt{pattern, options}).value();
+}
+
+isize RegexQt::replace(qstr const& subject, qstr const& after, qstr& out) const {
+    // Back references \1 ... \99 as QString::replace finds them (only existing groups, no escapes).
+    struct Piece {
+        qsizetype from;     // text of the replacement
+        qsizetype length;
+        int group;          // -1 - only the text
+    };
+    std::vector<Piece> pieces;
+    auto const groups = re_.captureCount();
+    auto const al = after.size();
+    qsizetype text{};
+    for (qsizetype i = 0; i < al - 1; ++i) {
+        if (after[i] not_eq u'\\')
+            continue;
+        auto no = after[i + 1].digitValue();
+        if (no <= 0 or no > groups)
+            continue;
+        qsizetype length = 2;
+        if (i < al - 2)
+            if (auto const second = after[i + 2].digitValue(); second not_eq -1 and no * 10 + second <= groups) {
+                no = no * 10 + second;
+                ++length;
+            }
+        pieces.push_back(Piece{.from = text, .length = i - text, .group = no});
+        text = i + length;
+        i += length - 1;
+    }
+    pieces.push_back(Piece{.from = text, .length = al - text, .group = -1});
+
+    // One pass - matches are counted while the result is built.
+    isize count{};
+    qsizetype last{};
+    for (auto it = re_.globalMatch(subject); it.hasNext();) {
+        auto const match = it.next();
+        if (count++ == 0) {
+            out.clear();
+            out.reserve(subject.size());
+        }
+        out.append(QStringView(subject).sliced(last, match.capturedStart() - last));
+        for (auto const& [from, length, group] : pieces) {
+            out.append(QStringView(after).sliced(from, length));
+            if (group > 0)
+                out.append(match.capturedView(group));
+        }
+        last = match.capturedEnd();
+    }
+    if (count)
+        out.append(QStringView(subject).sliced(last));
+    return count;
+}
@@ -0,0 +1,93 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include "Generator.h"
+#include <QRegularExpression>
+#include <QRegularExpressionMatchIterator>
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// QRegularExpression (Qt's bundled PCRE2 with JIT) working directly on QString. \n
+/// Compiled (and optimized) expressions are kept in the cache between runs.
+class RegexQt {
+    QRegularExpression re_{};
+public:
+    RegexQt() = default;
+    RegexQt(qstr const& pattern, QRegularExpression::PatternOptions options);
+
+    /// Checks if the pattern was compiled successfully.
+    [[nodiscard]] bool valid() const noexcept {
+        return re_.isValid();
+    }
+    /// Compilation error message with the offset in the pattern.
+    [[nodiscard]] qstr error() const noexcept {
+        return QString("compilation failed at offset %1: %2")
+                .arg(re_.patternErrorOffset())
+                .arg(re_.errorString());
+    }
+
+    /// One match (view, valid until the next match is requested). \n
+    /// Positions are QString positions.
+    struct Hit {
+        QRegularExpressionMatch const* match;
+
+        [[nodiscard]] int groups() const noexcept {
+            return match->lastCapturedIndex() + 1;
+        }
+        /// Start of the group or -1 if the group did not participate in the match.
+        [[nodiscard]] isize start(int const i) const noexcept {
+            return match->capturedStart(i);
+        }
+        [[nodiscard]] isize length(int const i) const noexcept {
+            return match->capturedLength(i);
+        }
+    };
+
+    /// Searches matches in the subject lazily (globalMatch iterator). \n
+    /// The subject must outlive the returned generator.
+    [[nodiscard]] Generator<Hit> matches(qstr const& subject) const;
+
+    /// Groups of the match that starts exactly at the offset (anchored match).
+    /// \return spans of all groups or empty if there is no match at the offset.
+    [[nodiscard]] Spans groups_at(qstr const& subject, isize offset) const noexcept;
+
+    /// Replaces all matches in the subject (as QString::replace does, in one pass of matching).
+    /// \param after - replacement (\1 ... \99 refer to groups),
+    /// \param out - the result,
+    /// \return number of replacements (0 - out is not changed).
+    isize replace(qstr const& subject, qstr const& after, qstr& out) const;
+
+    /// Returns compiled expression for the pattern and options. \n
+    /// The pattern is compiled only the first time it is seen,
+    /// copies are cheap (QRegularExpression is implicitly shared).
+    /// \param hit - set to true if the expression was found in the cache (may be null).
+    static RegexQt cached(qstr const& pattern, QRegularExpression::PatternOptions options, bool* hit = nullptr) noexcept;
+
+private:
+    static inline isize const CacheLimit = 256;
+};
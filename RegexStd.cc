@@ -0,0 +1,68 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "RegexStd.h"
+#include <iterator>
+
+Generator<RegexStd::Hit> RegexStd::matches(char const* const subject, std::size_t const n) const {
+    auto const end = std::cregex_iterator();
+    for (auto it = std::cregex_iterator(subject, subject + n, re_); it not_eq end; ++it)
+        co_yield Hit{&*it};
+}
+
+Spans RegexStd::groups_at(char const* const subject, std::size_t const n, std::size_t const offset) const {
+    auto flags = std::regex_constants::match_continuous;
+    // Characters before the offset are visible for ^, \b and so on.
+    if (offset > 0)
+        flags |= std::regex_constants::match_prev_avail;
+
+    std::cmatch match;
+    if (not std::regex_search(subject + offset, subject + n, match, re_, flags))
+        return {};
+
+    Hit const hit{&match};
+    Spans spans;
+    spans.reserve(hit.groups());
+    for (int i = 0; i < hit.groups(); ++i) {
+        auto const start = hit.start(i);
+        spans.push_back(Span{.start = start < 0 ? -1 : isize(offset) + start, .length = hit.length(i)});
+    }
+    return spans;
+}
+
+isize RegexStd::replace(char const* const subject, std::size_t const n, std::string const& format, std::string& out) const {
+    // What std::regex_replace does - text between matches is copied, matches are formatted.
+    isize count{};
+    auto tail = subject;
+    auto const end = std::cregex_iterator();
+    for (auto it = std::cregex_iterator(subject, subject + n, re_); it not_eq end; ++it, ++count) {
+        out.append(tail, (*it)[0].first);
+        it->format(std::back_inserter(out), format);
+        tail = (*it)[0].second;
+    }
+    out.append(tail, subject + n);
+    return count;
+}
@@ -0,0 +1,75 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include "Generator.h"
+#include <regex>
+#include <string>
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// Compiled std::regex, reusable for any number of subjects.
+class RegexStd {
+    std::regex re_;
+public:
+    /// One match (view, valid until the next match is requested). \n
+    /// Positions are in bytes.
+    struct Hit {
+        std::cmatch const* match;
+
+        [[nodiscard]] int groups() const noexcept {
+            return int(match->size());
+        }
+        /// Start of the group or -1 if the group did not participate in the match.
+        [[nodiscard]] isize start(int const i) const noexcept {
+            return (*match)[i].matched ? isize(match->position(i)) : -1;
+        }
+        [[nodiscard]] isize length(int const i) const noexcept {
+            return isize(match->length(i));
+        }
+    };
+
+    /// Compiles the pattern.
+    /// \throws std::regex_error if the pattern is invalid.
+    RegexStd(std::string const& pattern, type::StdSyntaxOption options) : re_{pattern, options} {}
+
+    /// Searches matches in the subject lazily (next match is searched when requested). \n
+    /// The expression must outlive the returned generator.
+    /// \param subject - the text to search (need not be zero terminated),
+    /// \param n - number of bytes in the subject.
+    [[nodiscard]] Generator<Hit> matches(char const* subject, std::size_t n) const;
+
+    /// Groups of the match that starts exactly at the offset (anchored match).
+    /// \return spans of all groups or empty if there is no match at the offset.
+    [[nodiscard]] Spans groups_at(char const* subject, std::size_t n, std::size_t offset) const;
+
+    /// Replaces all matches in the subject (the same as std::regex_replace, but counted).
+    /// \param format - replacement in the ECMAScript format ($&, $1, $$...),
+    /// \param out - the result is appended here,
+    /// \return number of replacements.
+    isize replace(char const* subject, std::size_t n, std::string const& format, std::string& out) const;
+};
@@ -0,0 +1,105 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+/*------- stratified random sampling:
+-------------------------------------------------------------------*/
+namespace sampling {
+    /// Estimated value with margin of error (95% confidence).
+    struct Estimate {
+        double value{};
+        double margin{};
+    };
+
+    /// One stratum - contiguous part of the population and indexes sampled from it.
+    struct Stratum {
+        isize size{};
+        std::vector<isize> indexes{};
+    };
+
+    /// Split the population into contiguous strata (parts of the text are often different,
+    /// e.g. a log over time) and draw from every stratum proportionally without replacement.
+    /// \param population - number of items (lines),
+    /// \param size - requested sample size (the whole population if not smaller),
+    /// \param strata - number of strata,
+    /// \param seed - seed of the random generator (the same seed - the same sample).
+    inline std::vector<Stratum> draw(isize const population, isize const size, isize const strata, u64 const seed) {
+        std::vector<Stratum> result;
+        if (population <= 0)
+            return result;
+
+        std::mt19937_64 random{seed};
+        auto const k = std::clamp<isize>(strata, 1, population);
+        result.reserve(std::size_t(k));
+        for (isize h = 0; h < k; ++h) {
+            auto const first = h * population / k;
+            auto const last = (h + 1) * population / k;
+            Stratum stratum{.size = last - first};
+            // Proportional allocation, at least two items (for variance) if possible.
+            auto n = (size * stratum.size + population - 1) / population;
+            n = std::clamp<isize>(n, std::min<isize>(2, stratum.size), stratum.size);
+            std::vector<isize> all(std::size_t(stratum.size));
+            std::iota(all.begin(), all.end(), first);
+            stratum.indexes.reserve(std::size_t(n));
+            std::sample(all.cbegin(), all.cend(), std::back_inserter(stratum.indexes), n, random);
+            result.push_back(std::move(stratum));
+        }
+        return result;
+    }
+
+    /// Estimate of the population total of a value measured on sampled items.
+    /// \param strata - the strata of the sample,
+    /// \param values - measured values for every stratum (in the order of indexes).
+    inline Estimate total(std::vector<Stratum> const& strata, std::vector<std::vector<double>> const& values) {
+        constexpr double Z95 = 1.96;
+        double sum{};
+        double variance{};
+        for (std::size_t h = 0; h < strata.size(); ++h) {
+            auto const& x = values[h];
+            auto const n = double(x.size());
+            auto const N = double(strata[h].size);
+            if (x.empty()) continue;
+
+            auto const mean = std::accumulate(x.cbegin(), x.cend(), 0.0) / n;
+            sum += N * mean;
+            if (x.size() < 2) continue;
+            double ss{};
+            for (auto const v : x)
+                ss += (v - mean) * (v - mean);
+            auto const s2 = ss / (n - 1);
+            // Finite population correction - the whole stratum sampled has no error.
+            variance += N * N * (1.0 - n / N) * s2 / n;
+        }
+        return {sum, Z95 * std::sqrt(variance)};
+    }
+}
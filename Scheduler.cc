@@ -0,0 +1,112 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Scheduler.h"
+#include "EventController.h"
+#include "Stage.h"
+#include "Trace.h"
+#include <algorithm>
+#include <fmt/core.h>
+
+/*------- class implementation:
+-------------------------------------------------------------------*/
+Scheduler::Scheduler(unsigned const threads) {
+    auto const n = std::max(threads, 1u);
+    workers_.reserve(n);
+    for (unsigned i = 0; i < n; ++i)
+        workers_.emplace_back([this, i] {
+            trace::name_thread(fmt::format("worker {}", i + 1));
+            work();
+        });
+}
+
+Scheduler::~Scheduler() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_)
+        worker.join();
+}
+
+void Scheduler::submit(std::shared_ptr<Task> task) noexcept {
+    task->queued = Run::Clock::now();
+    {
+        std::lock_guard lock(mutex_);
+        queue_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+std::shared_ptr<Task> Scheduler::pick() noexcept {
+    std::unique_lock lock(mutex_);
+    cv_.wait(lock, [this] { return stop_ or not queue_.empty(); });
+    if (stop_)
+        return {};
+
+    auto it = std::ranges::find_if(queue_, [](auto const& task) { return task->foreground.load(); });
+    if (it == queue_.end())
+        it = queue_.begin();
+    auto task = std::move(*it);
+    queue_.erase(it);
+    return task;
+}
+
+void Scheduler::work() noexcept {
+    while (auto task = pick())
+        if (slice(*task))
+            submit(std::move(task));
+}
+
+bool Scheduler::slice(Task& task) noexcept {
+    if (task.cancelled)
+        return false;
+    // Waiting of the task for a free worker (other tasks had their slices).
+    if (trace::recording.load(std::memory_order_relaxed))
+        trace::record("queued", "scheduler", task.queued, Run::Clock::now());
+
+    try {
+        stage::Scope const scope{stage::Scan};
+        task.status = task.run->advance(*task.sink, Run::Clock::now() + Slice);
+        if (task.status == Run::Status::Slice)
+            return not task.cancelled;
+    }
+    catch (std::exception const& e) {
+        // e.g. std::regex_error (error_complexity, error_stack) thrown while matching.
+        task.error = e.what();
+        task.sink->line(fmt::format("ERROR: {}", e.what()));
+        task.status = Run::Status::Done;
+    }
+    // Nobody waits for results of a cancelled task.
+    if (task.cancelled)
+        return false;
+    // Results of the tab are shown as soon as it is done.
+    task.sink->finish();
+    task.finished = true;
+    EventController::instance().post(task.owner, event::RunDone);
+    return false;
+}
@@ -0,0 +1,98 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include "Search.h"
+#include "Sink.h"
+#include <QObject>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*------- classes:
+-------------------------------------------------------------------*/
+/// Run of one window executed by the scheduler. \n
+/// While the task is in the scheduler only workers touch the run and the sink,
+/// the owner gets them back after event::RunDone. A cancelled task is not waited for -
+/// the worker drops it (with the run and the sink) when its slice ends.
+struct Task {
+    std::unique_ptr<Run> run;
+    std::unique_ptr<Sink> sink;             // the matches-view or a file (export)
+    QObject* const owner;                   // receiver of event::RunDone
+    std::atomic<bool> foreground{};         // the visible tab goes first
+    std::atomic<bool> cancelled{};          // the owner does not want results any more
+    std::atomic<bool> finished{};           // the run and the sink can be taken back
+    Run::Status status{Run::Status::Done};
+    std::string error{};                    // why the run could not continue
+    Run::Clock::time_point queued{};        // when the task was put in the queue (for the trace)
+
+    Task(std::unique_ptr<Run> run, std::unique_ptr<Sink> sink, QObject* const owner, bool const foreground) :
+        run{std::move(run)},
+        sink{std::move(sink)},
+        owner{owner},
+        foreground{foreground}
+    {}
+};
+
+/// Shared pool of worker threads for runs of all windows. \n
+/// Runs are executed in time slices; after every slice the task goes back to the queue
+/// and the next one is picked - foreground tasks first, so background tasks yield
+/// to the visible tab at most one slice later.
+class Scheduler {
+public:
+    explicit Scheduler(unsigned threads = std::thread::hardware_concurrency());
+    ~Scheduler();
+    Scheduler(Scheduler const&) = delete;
+    Scheduler& operator=(Scheduler const&) = delete;
+
+    /// Queue the task (it is executed as soon as a worker is free).
+    void submit(std::shared_ptr<Task> task) noexcept;
+
+private:
+    /// Loop of one worker thread.
+    void work() noexcept;
+
+    /// Wait for the next task - a foreground one if there is any.
+    /// \return the task or nullptr if the scheduler stops.
+    std::shared_ptr<Task> pick() noexcept;
+
+    /// Scan the task for one slice.
+    /// \return true if the task needs next slices.
+    static bool slice(Task& task) noexcept;
+
+    std::mutex mutex_{};
+    std::condition_variable cv_{};
+    std::deque<std::shared_ptr<Task>> queue_{};
+    bool stop_{};
+    std::vector<std::thread> workers_{};
+    static constexpr auto Slice = std::chrono::milliseconds(4);
+};
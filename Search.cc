@@ -0,0 +1,540 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Search.h"
+#include "Sampling.h"
+#include "Subject.h"
+#include "RegexQt.h"
+#include "RegexStd.h"
+#ifdef PCRE2_REGEX
+    #include "RegexPcre.h"
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <fmt/core.h>
+
+namespace {
+    /// Estimate of memory taken by the line in the matches-view (UTF-16 text in a block).
+    isize line_bytes(std::string const& text) noexcept {
+        return isize(2 * text.size() + sizeof(qstr));
+    }
+    /// Estimate of memory taken by the match kept for highlighting.
+    isize match_bytes(Match const& match) noexcept {
+        return isize(sizeof(Match) + match.str.size());
+    }
+
+    /// Sink which measures results on the way to the real sink.
+    class Metered : public Sink {
+        Sink& sink_;
+        isize& bytes_;
+    public:
+        Metered(Sink& sink, isize& bytes) : sink_{sink}, bytes_{bytes} {}
+        void line(std::string const& text, int const ref) override {
+            bytes_ += line_bytes(text);
+            sink_.line(text, ref);
+        }
+        void highlight(Match&& match) override {
+            bytes_ += match_bytes(match);
+            sink_.highlight(std::move(match));
+        }
+        void finish() override {
+            sink_.finish();
+        }
+    };
+
+    /// Name of the engine for the report.
+    template<typename Engine, typename Subject>
+    char const* engine_name() noexcept {
+        if constexpr (std::is_same_v<Engine, RegexStd>)
+            return "std";
+        else if constexpr (std::is_same_v<Engine, RegexQt>)
+            return "qt";
+        else if constexpr (std::is_same_v<Subject, Utf8Subject>)
+            return "pcre2 (UTF-8)";
+        else
+            return "pcre2";
+    }
+
+    double ms(Run::Clock::duration const d) noexcept {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+    double mb_per_s(isize const bytes, double const ms) noexcept {
+        return ms > 0 ? double(bytes) / (1024.0 * 1024.0) / (ms / 1000) : 0.0;
+    }
+    Hardware hardware(perf::Sample const& s, isize const bytes) noexcept {
+        using namespace perf;
+        return Hardware::of(s[Cycles], s[Instructions], s[BranchMisses], s[L1Misses], s[LlcMisses], s[PageFaults], bytes);
+    }
+    Allocations allocations(stage::heap::Usage const& usage) noexcept {
+        return {.count = usage.allocations, .bytes = usage.bytes, .peak = usage.peak};
+    }
+}
+
+/*------- class implementation:
+-------------------------------------------------------------------*/
+Generator<Run::Status> Run::slices(Sink& sink, Clock::duration const slice) {
+    while (true) {
+        auto const status = advance(sink, Clock::now() + slice);
+        co_yield status;
+        if (status not_eq Status::Slice)
+            co_return;
+    }
+}
+
+template<typename Engine, typename Subject>
+void Search<Engine, Subject>::reset(isize const limit) {
+    limit_ = limit;
+    cursor_ = {};
+    tally_ = {};
+    found_ = 0;
+    result_bytes_ = 0;
+    pending_ = {};
+    held_ = false;
+    counts_ = TopK{};
+    refs_.clear();
+    for (auto& pattern : patterns_)
+        pattern.meter = {};
+    latency_.assign(subjects_.size(), {});
+    counted_ = false;
+    next_page();
+}
+
+template<typename Engine, typename Subject>
+void Search<Engine, Subject>::next_page() {
+    // Count and group-by do not send matches, nothing to split into pages.
+    budget_ = (limit_ > 0 and streamed())
+            ? limit_
+            : std::numeric_limits<isize>::max();
+}
+
+template<typename Engine, typename Subject>
+Run::Status Search<Engine, Subject>::advance(Sink& target, Clock::time_point const deadline) {
+    Metered metered{target, result_bytes_};
+    Sink& sink = metered;
+    // The clock (and counters) are read only when the scan returns or the pattern is finished.
+    // Slices may run on different threads - every one has its own counters.
+    auto const& counters = perf::Counters::local();
+    stage::heap::Probe heap;
+    counted_ = counted_ or counters.available();
+    // Spans of the trace: the pattern (its part in this call) and every source.
+    auto const traced = trace::recording.load(std::memory_order_relaxed);
+    auto start = Clock::now();
+    auto sample = counters.read();
+    auto const measure = [&](Pattern& pattern) {
+        auto const now = Clock::now();
+        auto const values = counters.read();
+        auto& meter = pattern.meter;
+        meter.time += now - start;
+        meter.counters += values - sample;
+        meter.heap += heap.take();
+        if (traced)
+            trace::record(pattern.text.toStdString(), "match", start, now);
+        start = now;
+        sample = values;
+    };
+
+    for (; cursor_.pattern < int(patterns_.size()); ++cursor_.pattern) {
+        auto& pattern = patterns_[cursor_.pattern];
+        for (; cursor_.subject < int(subjects_.size()); ++cursor_.subject) {
+            auto const& subject = subjects_[cursor_.subject];
+            auto const begin = traced ? Clock::now() : Clock::time_point{};
+            auto const status = with_engine(pattern, subject, [&](auto const& rgx) {
+                return scan(rgx, sink, deadline);
+            });
+            if (traced)
+                trace::record("source", "match", begin, Clock::now(), {{"line", std::to_string(subject.line() + 1)}});
+            if (status == Status::Limit)
+                sink.line(fmt::format("... stopped after {} matches (next: line {}, offset {}) ...",
+                                      limit_, subject.line() + 1, cursor_.offset));
+            if (status not_eq Status::Done) {
+                measure(pattern);
+                return status;
+            }
+            pattern.meter.bytes += isize(subject.size());
+        }
+        if (granularity_ == Granularity::GroupBy)
+            table(sink);
+        sink.line(fmt::format("=== '{}': {} matches in {} of {} lines ===",
+                              pattern.text.toStdString(), tally_.matches, tally_.lines, subjects_.size()));
+        pattern.meter.lines = tally_.lines;
+        pattern.meter.matches = tally_.matches;
+        measure(pattern);
+        cursor_.subject = 0;
+        tally_ = {};
+        counts_ = TopK{};
+    }
+    return Status::Done;
+}
+
+template<typename Engine, typename Subject>
+template<typename E>
+Run::Status Search<Engine, Subject>::scan(E const& rgx, Sink& sink, Clock::time_point const deadline) {
+    using Matches = Generator<typename E::Hit>;
+    auto const& subject = subjects_[cursor_.subject];
+    // Clock is read only when there is a deadline (once for some matches).
+    auto const timed = deadline not_eq Clock::time_point::max();
+    auto const over = [timed, deadline] {
+        return timed and Clock::now() >= deadline;
+    };
+
+    // The source is started or continued where the previous page (slice) stopped.
+    if (not std::holds_alternative<Matches>(pending_)) {
+        cursor_.offset = 0;
+        cursor_.found = 0;
+        if (over())
+            return Status::Slice;
+        pending_ = subject.matches(rgx);
+    }
+    auto& matches = std::get<Matches>(pending_);
+    for (isize i = 1; ; ++i) {
+        if (i % ClockStep == 0 and over())
+            return Status::Slice;
+        // The match held at the end of the previous page is sent first.
+        typename E::Hit const* hit{};
+        if (std::exchange(held_, false)) {
+            hit = matches.current();
+        } else {
+            // Latency of the source is the time of the engine only (vDSO clock, no system call),
+            // sending of results does not make a line with many matches slow.
+            auto const begin = Clock::now();
+            hit = matches.next();
+            latency_[cursor_.subject] += Clock::now() - begin;
+        }
+        if (not hit)
+            break;
+        // The page is full - it ends only when another match exists (the generator keeps it).
+        if (budget_ == 0) {
+            held_ = true;
+            cursor_.offset = hit->start(0);
+            return Status::Limit;
+        }
+        ++cursor_.found;
+        --budget_;
+        cursor_.offset = hit->start(0) + hit->length(0);
+        emit(*hit, subject, sink);
+        // Like 'grep -l' - the first match is enough.
+        if (granularity_ == Granularity::Any)
+            break;
+    }
+    pending_ = {};
+
+    if (auto const n = cursor_.found; n) {
+        ++tally_.lines;
+        tally_.matches += n;
+        found_ += n;
+        if (streamed() and granularity_ not_eq Granularity::Any)
+            sink.line("--- END ---");
+    }
+    return Status::Done;
+}
+
+template<typename Engine, typename Subject>
+template<typename Hit>
+void Search<Engine, Subject>::emit(Hit const& hit, Subject const& subject, Sink& sink) {
+    switch (granularity_) {
+        case Granularity::Any: {
+            auto m = subject.span(0, hit.start(0), hit.length(0));
+            sink.line(fmt::format("line {}: ({}, {})", m.line + 1, hit.start(0), hit.length(0)));
+            sink.highlight(std::move(m));
+            return;
+        }
+        case Granularity::Count:
+            return;
+        case Granularity::GroupBy:
+            // Only the value is counted, nothing is sent.
+            if (group_ < hit.groups())
+                if (auto const pos = hit.start(group_); pos >= 0)
+                    counts_.add(subject.shown(pos, hit.length(group_)));
+            return;
+        case Granularity::OnDemand: {
+            // Only whole matches, groups are found when the user asks for them.
+            auto const pos = hit.start(0);
+            auto const length = hit.length(0);
+            auto const ref = int(refs_.size());
+            refs_.push_back(Ref{.pattern = cursor_.pattern, .subject = cursor_.subject, .offset = pos});
+            sink.line(fmt::format("$0: '{}' ({}, {})", subject.shown(pos, length), pos, length), ref);
+            sink.highlight(subject.match(0, pos, length));
+            return;
+        }
+        case Granularity::Offsets:
+        case Granularity::Full:
+            break;
+    }
+
+    auto const full = granularity_ == Granularity::Full;
+    sink.line("--------------------------");
+    for (int i = 0; i < hit.groups(); ++i) {
+        auto const pos = hit.start(i);
+        if (pos < 0) continue;  // group did not participate in the match
+        auto const length = hit.length(i);
+        // Positions are displayed as the engine reports them.
+        sink.line(full
+                  ? fmt::format("${}: '{}' ({}, {})", i, subject.shown(pos, length), pos, length)
+                  : fmt::format("${}: ({}, {})", i, pos, length));
+        sink.highlight(full ? subject.match(i, pos, length) : subject.span(i, pos, length));
+    }
+}
+
+template<typename Engine, typename Subject>
+void Search<Engine, Subject>::sample(Sink& sink, isize const size) {
+    using clock = std::chrono::steady_clock;
+    /// Sink which only measures what would be sent (size of results).
+    struct Measure : Sink {
+        isize bytes{};
+        void line(std::string const& text, int) override {
+            bytes += line_bytes(text);
+        }
+        void highlight(Match&& match) override {
+            bytes += match_bytes(match);
+        }
+    };
+
+    // In the whole document the population is its lines - sampled lines are matched as subjects
+    // of their own (matches across lines are not estimated), the document is never matched as a whole.
+    auto const document = subjects_.size() == 1 and subjects_.front().document();
+    std::vector<isize> starts;
+    if (document) {
+        auto const& whole = subjects_.front();
+        auto const begin = whole.data();
+        auto const end = begin + whole.size();
+        starts.push_back(0);
+        for (auto it = std::find(begin, end, '\n'); it not_eq end; it = std::find(it + 1, end, '\n'))
+            starts.push_back(isize(it - begin) + 1);
+    }
+    auto const population = document ? isize(starts.size()) : isize(subjects_.size());
+    auto const strata = sampling::draw(population, size, SampleStrata, SampleSeed);
+    isize sampled{};
+    std::unordered_map<isize, Subject> parts;
+    for (auto const& stratum : strata) {
+        sampled += isize(stratum.indexes.size());
+        if (document)
+            for (auto const i : stratum.indexes) {
+                auto const end = std::size_t(i + 1) < starts.size()
+                        ? starts[std::size_t(i + 1)] - 1
+                        : isize(subjects_.front().size());
+                auto const start = starts[std::size_t(i)];
+                parts.emplace(i, subjects_.front().part(start, end - start, int(i)));
+            }
+    }
+
+    for (int p = 0; p < int(patterns_.size()); ++p) {
+        auto const& pattern = patterns_[p];
+        cursor_.pattern = p;
+        // Values measured for every sampled source (grouped by strata).
+        std::vector<std::vector<double>> matches(strata.size());
+        std::vector<std::vector<double>> lines(strata.size());
+        std::vector<std::vector<double>> times(strata.size());
+        std::vector<std::vector<double>> bytes(strata.size());
+        for (std::size_t h = 0; h < strata.size(); ++h) {
+            for (auto const i : strata[h].indexes) {
+                auto const& subject = document ? parts.at(i) : subjects_[std::size_t(i)];
+                cursor_.subject = document ? 0 : int(i);
+                Measure measure;
+                isize n{};
+                auto const start = clock::now();
+                with_engine(pattern, subject, [&](auto const& rgx) {
+                    for (auto const& hit : subject.matches(rgx)) {
+                        ++n;
+                        emit(hit, subject, measure);
+                        if (granularity_ == Granularity::Any)
+                            break;
+                    }
+                });
+                auto const ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+                matches[h].push_back(double(n));
+                lines[h].push_back(n ? 1.0 : 0.0);
+                times[h].push_back(ns);
+                bytes[h].push_back(double(measure.bytes));
+            }
+        }
+
+        auto const m = sampling::total(strata, matches);
+        auto const l = sampling::total(strata, lines);
+        auto const t = sampling::total(strata, times);
+        auto const b = sampling::total(strata, bytes);
+        auto const percent = population ? 100.0 / double(population) : 0.0;
+        sink.line(fmt::format("=== sample of '{}': {} of {} lines ({} strata){} ===",
+                              pattern.text.toStdString(), sampled, population, strata.size(),
+                              document ? ", lines of the document matched one by one" : ""));
+        sink.line(fmt::format("matches:     {:.0f} +/- {:.0f}", m.value, m.margin));
+        sink.line(fmt::format("selectivity: {:.2f}% +/- {:.2f}% of lines", l.value * percent, l.margin * percent));
+        sink.line(fmt::format("time:        {:.2f} ms +/- {:.2f} ms (without the GUI)", t.value / 1e6, t.margin / 1e6));
+        sink.line(fmt::format("memory:      {:.1f} KB +/- {:.1f} KB (results)", b.value / 1024, b.margin / 1024));
+    }
+    // Sampling leaves nothing behind - the run starts from the beginning.
+    cursor_ = {};
+    pending_ = {};
+    held_ = false;
+    refs_.clear();
+    counts_ = TopK{};
+}
+
+template<typename Engine, typename Subject>
+RunStats Search<Engine, Subject>::stats() const {
+    RunStats run{
+        .engine = engine_name<Engine, Subject>(),
+        .sources = isize(subjects_.size()),
+        .matches = found_,
+        .result_bytes = result_bytes_ + isize(refs_.size() * sizeof(Ref))};
+
+    perf::Sample counters;
+    stage::heap::Usage heap;
+    auto const hooked = stage::heap::hooked.load(std::memory_order_relaxed);
+    for (int i = 0; i < int(patterns_.size()); ++i) {
+        auto const& pattern = patterns_[i];
+        auto const& meter = pattern.meter;
+        // Counts of the pattern being scanned are not in its meter yet.
+        auto const current = i == cursor_.pattern;
+        PatternStats stats{
+            .pattern = pattern.text.toStdString(),
+            .compile_ms = pattern.compiled.ms,
+            .match_ms = ms(meter.time),
+            .bytes = meter.bytes * isize(sizeof(*subjects_.front().data())),
+            .lines = current ? tally_.lines : meter.lines,
+            .matches = current ? tally_.matches : meter.matches,
+            .cached = pattern.compiled.cached};
+        stats.mb_per_s = mb_per_s(stats.bytes, stats.match_ms);
+        if (counted_) {
+            stats.hardware = hardware(meter.counters, stats.bytes);
+            counters += meter.counters;
+        }
+        if (hooked) {
+            stats.heap = allocations(meter.heap);
+            heap += meter.heap;
+        }
+        if constexpr (requires(Engine const& e) { e.code_size(); e.jit_size(); }) {
+            // Every engine of the pattern is in the memory.
+            for (auto const* rgx : {pattern.scanner.get(), pattern.capturer.get(), pattern.ascii.get()})
+                if (rgx) {
+                    stats.code_size += isize(rgx->code_size());
+                    stats.jit_size += isize(rgx->jit_size());
+                }
+        }
+
+        run.compile_ms += stats.compile_ms;
+        run.match_ms += stats.match_ms;
+        run.bytes += stats.bytes;
+        if (stats.cached)
+            ++run.cache_hits;
+        run.patterns.push_back(std::move(stats));
+    }
+    run.mb_per_s = mb_per_s(run.bytes, run.match_ms);
+    if (counted_)
+        run.hardware = hardware(counters, run.bytes);
+    if (hooked)
+        run.heap = allocations(heap);
+    latency(run);
+    return run;
+}
+
+template<typename Engine, typename Subject>
+void Search<Engine, Subject>::latency(RunStats& run) const {
+    // The whole document is one source - the time of lines is not known.
+    if (subjects_.size() == 1 and subjects_.front().document()) {
+        run.document = true;
+        return;
+    }
+    auto const us = [](Clock::duration const d) {
+        return std::chrono::duration<double, std::micro>(d).count();
+    };
+
+    // Buckets from 1 us, every next one HistogramBase times longer (the last one is open).
+    std::vector<isize> counts(HistogramSize);
+    std::vector<int> scanned;
+    scanned.reserve(latency_.size());
+    for (int i = 0; i < int(latency_.size()); ++i) {
+        if (latency_[i] == Clock::duration::zero())
+            continue;
+        scanned.push_back(i);
+        auto const t = us(latency_[i]);
+        auto const bucket = t < 1 ? 0 : 1 + int(std::log(t) / std::log(HistogramBase));
+        ++counts[std::min(bucket, HistogramSize - 1)];
+    }
+    auto const first = std::ranges::find_if(counts, [](isize const n) { return n > 0; }) - counts.begin();
+    auto last = int(counts.size());
+    while (last > first and counts[last - 1] == 0)
+        --last;
+    for (auto i = int(first); i < last; ++i)
+        run.histogram.push_back(Bucket{
+            .from_us = i == 0 ? 0.0 : std::pow(HistogramBase, i - 1),
+            .lines = counts[i]});
+
+    auto const n = std::min(SlowestCount, scanned.size());
+    std::ranges::partial_sort(scanned, scanned.begin() + isize(n), [this](int const a, int const b) {
+        return latency_[a] > latency_[b];
+    });
+    for (std::size_t i = 0; i < n; ++i)
+        run.slowest.push_back(SlowLine{
+            .line = subjects_[scanned[i]].line(),
+            .us = us(latency_[scanned[i]])});
+}
+
+template<typename Engine, typename Subject>
+void Search<Engine, Subject>::table(Sink& sink) const {
+    auto const items = counts_.top(TopCount);
+    sink.line(counts_.exact()
+              ? fmt::format("=== ${}: {} values, {} distinct ===", group_, counts_.total(), counts_.distinct())
+              : fmt::format("=== ${}: {} values, more than {} distinct (approximate counts) ===",
+                            group_, counts_.total(), counts_.distinct()));
+    for (auto const& [value, count, error] : items)
+        sink.line(error
+                  ? fmt::format("{:>12} (+/- {})  '{}'", count, error, value)
+                  : fmt::format("{:>12}  '{}'", count, value));
+}
+
+template<typename Engine, typename Subject>
+strings Search<Engine, Subject>::groups(int const ref) const {
+    if (ref < 0 or ref >= int(refs_.size()))
+        return {};
+
+    auto const& [pattern, nr, offset] = refs_[ref];
+    auto const& capturer = patterns_[pattern].capturer;
+    if (not capturer)
+        return {};
+
+    auto const& subject = subjects_[nr];
+    auto const spans = subject.groups_at(*capturer, offset);
+    strings lines;
+    for (int i = 1; i < int(spans.size()); ++i) {
+        auto const [pos, length] = spans[i];
+        if (pos < 0) continue;
+        lines.push_back(fmt::format("${}: '{}' ({}, {})", i, subject.shown(pos, length), pos, length));
+    }
+    return lines;
+}
+
+/*------- explicit instantiations:
+-------------------------------------------------------------------*/
+template class Search<RegexStd, Utf8Subject>;
+template class Search<RegexQt, Utf16Subject>;
+#ifdef PCRE2_REGEX
+template class Search<RegexPcre, Utf8Subject>;
+template class Search<RegexPcre16, Utf16Subject>;
+#endif
@@ -0,0 +1,289 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include "Sink.h"
+#include "Literal.h"
+#include "Generator.h"
+#include "TopK.h"
+#include "Counters.h"
+#include "Stage.h"
+#include "Trace.h"
+#include "model/Stats.h"
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+/*------- classes:
+-------------------------------------------------------------------*/
+/// One run (all patterns with all sources) independent of the engine. \n
+/// The run is kept after the scan - groups of matches can be found later (on demand)
+/// and the scan stopped at the limit can be continued (next page).
+/// The scan can be also split into time slices (cooperative execution on the GUI thread).
+class Run {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Why the scan returned.
+    enum class Status {
+        Done,   // all patterns with all sources
+        Limit,  // the page is full (next_page continues)
+        Slice,  // the time slice is over (advance continues)
+    };
+
+    virtual ~Run() = default;
+
+    /// Prepare the scan from the beginning.
+    /// \param limit - the page ends after so many matches (0 - no limit).
+    virtual void reset(isize limit) = 0;
+
+    /// Prepare the next page of the scan stopped at the limit (with the same limit).
+    virtual void next_page() = 0;
+
+    /// Scan from where the previous call stopped, results go to the sink.
+    /// \param sink - receiver of results,
+    /// \param deadline - the scan returns (Slice) when the time is over.
+    virtual Status advance(Sink& sink, Clock::time_point deadline = Clock::time_point::max()) = 0;
+
+    /// Scan all sources with all patterns from the beginning at once.
+    /// \param sink - receiver of results,
+    /// \param limit - the scan stops after so many matches (0 - no limit).
+    /// \return true if the scan stopped at the limit (more() continues).
+    bool scan(Sink& sink, isize const limit = 0) {
+        reset(limit);
+        return advance(sink) == Status::Limit;
+    }
+
+    /// Continue the scan stopped at the limit at once (next page).
+    /// \return true if the scan stopped at the limit again.
+    bool more(Sink& sink) {
+        next_page();
+        return advance(sink) == Status::Limit;
+    }
+
+    /// The scan as a coroutine - every step scans for one time slice. \n
+    /// The consumer (the event loop) resumes it when it has time; the last value is Done or Limit.
+    /// \param sink - receiver of results,
+    /// \param slice - time of one step.
+    Generator<Status> slices(Sink& sink, Clock::duration slice);
+
+    /// Estimate results of the full scan from a stratified random sample of sources. \n
+    /// Estimates (with 95% confidence bounds) of every pattern go to the sink.
+    /// The whole document is sampled by its lines (each one matched alone).
+    /// \param sink - receiver of the report,
+    /// \param size - number of sampled sources.
+    virtual void sample(Sink& sink, isize size) = 0;
+
+    /// Groups of the match (found again with anchored match at its position).
+    /// \param ref - id of the match given to the sink,
+    /// \return descriptions of groups (without the whole match).
+    [[nodiscard]] virtual strings groups(int ref) const = 0;
+
+    /// Number of matches found since reset (all patterns).
+    [[nodiscard]] virtual isize found() const noexcept = 0;
+
+    /// Measurements of the scan since reset (for the metrics panel).
+    /// \return empty stats (without patterns) if the run doesn't measure itself.
+    [[nodiscard]] virtual RunStats stats() const {
+        return {};
+    }
+};
+
+/// How the pattern was compiled (for measurements of the run).
+struct Compiled {
+    double ms{};        // time of the compilation (with JIT)
+    bool cached{};      // taken from the cache, not compiled
+    Run::Clock::time_point start{};     // for the trace
+
+    /// Compilation which started at the time and ends now.
+    static Compiled since(Run::Clock::time_point const start, bool const cached = false) noexcept {
+        return {
+            .ms = std::chrono::duration<double, std::milli>(Run::Clock::now() - start).count(),
+            .cached = cached,
+            .start = start};
+    }
+};
+
+/// Run with the concrete engine and the form of the source text.
+template<typename Engine, typename Subject>
+class Search : public Run {
+public:
+    /// \param granularity - what is sent to the sink,
+    /// \param subjects - the sources,
+    /// \param group - group whose values are counted (GroupBy only).
+    Search(Granularity granularity, std::vector<Subject> subjects, int group = 0) :
+        granularity_{granularity},
+        subjects_{std::move(subjects)},
+        group_{group}
+    {}
+
+    /// Add pattern compiled for the scan.
+    /// \param text - the pattern (for summary),
+    /// \param scanner - engine used for the scan,
+    /// \param capturer - engine with captures for groups on demand (may be null),
+    /// \param ascii - engine without UTF used for pure ASCII sources (may be null),
+    /// \param compiled - how the engines were compiled.
+    void add(qstr text,
+             std::unique_ptr<Engine const> scanner,
+             std::unique_ptr<Engine const> capturer = {},
+             std::unique_ptr<Engine const> ascii = {},
+             Compiled const compiled = {}) noexcept
+    {
+        traced(text, compiled);
+        patterns_.push_back(Pattern{
+            .text = std::move(text),
+            .scanner = std::move(scanner),
+            .capturer = std::move(capturer),
+            .ascii = std::move(ascii),
+            .compiled = compiled});
+    }
+
+    /// Add pattern searched as plain text.
+    void add(qstr text, Literal literal, Compiled const compiled = {}) noexcept {
+        traced(text, compiled);
+        patterns_.push_back(Pattern{.text = std::move(text), .literal = std::move(literal), .compiled = compiled});
+    }
+
+    void reset(isize limit) override;
+    void next_page() override;
+    Status advance(Sink& sink, Clock::time_point deadline) override;
+    void sample(Sink& sink, isize size) override;
+    [[nodiscard]] strings groups(int ref) const override;
+    [[nodiscard]] isize found() const noexcept override {
+        return found_;
+    }
+    [[nodiscard]] RunStats stats() const override;
+
+private:
+    /// Measurements of the pattern since reset.
+    struct Meter {
+        Clock::duration time{};     // scan of sources with the formatting of results
+        isize bytes{};              // scanned (in code units of sources)
+        isize lines{};
+        isize matches{};
+        perf::Sample counters{};    // the same work as the time
+        stage::heap::Usage heap{};  // the same work as the time
+    };
+    struct Pattern {
+        qstr text;
+        std::unique_ptr<Engine const> scanner{};
+        std::unique_ptr<Engine const> capturer{};
+        std::unique_ptr<Engine const> ascii{};
+        std::optional<Literal> literal{};
+        Compiled compiled{};
+        Meter meter{};
+    };
+    /// Place of the match (for groups on demand).
+    struct Ref {
+        int pattern;
+        int subject;
+        isize offset;
+    };
+    /// Where the scan continues (next page).
+    struct Cursor {
+        int pattern{};      // index of the pattern
+        int subject{};      // index of the source
+        isize offset{};     // position after the last match in the source (of the next one at the limit)
+        isize found{};      // matches found in the source so far
+    };
+    /// Matches of one pattern in all sources.
+    struct Tally {
+        isize lines{};      // number of lines with a match
+        isize matches{};    // number of all matches
+    };
+    /// Matches of the source not consumed yet (the generator stopped at the limit).
+    using Pending = std::variant<std::monostate, Generator<typename Engine::Hit>, Generator<Literal::Hit>>;
+
+    /// Call the function with the engine selected for the source (literal, ASCII or the scanner).
+    template<typename F>
+    static decltype(auto) with_engine(Pattern const& pattern, Subject const& subject, F&& f) {
+        if (pattern.literal)
+            return f(*pattern.literal);
+        if (pattern.ascii and subject.ascii())
+            return f(*pattern.ascii);
+        return f(*pattern.scanner);
+    }
+
+    /// Scan the source at the cursor (from the pending generator if there is one).
+    /// \param rgx - the engine selected for the source,
+    /// \param deadline - end of the time slice,
+    /// \return Done if the source was finished, otherwise why it was not
+    /// (Limit only if there is another match - the last page does not end with an empty one).
+    template<typename E>
+    Status scan(E const& rgx, Sink& sink, Clock::time_point deadline);
+
+    /// Send one match to the sink (as the granularity wants).
+    template<typename Hit>
+    void emit(Hit const& hit, Subject const& subject, Sink& sink);
+
+    /// Send the table of the most frequent values of the group (GroupBy).
+    void table(Sink& sink) const;
+
+    /// Compilation of the pattern as a span of the trace (if it is recording).
+    static void traced(qstr const& text, Compiled const& compiled) noexcept {
+        if (not trace::recording.load(std::memory_order_relaxed) or compiled.start == Clock::time_point{})
+            return;
+        auto const end = compiled.start + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double, std::milli>(compiled.ms));
+        trace::record("compile", "prepare", compiled.start, end, {{"pattern", text.toStdString()}});
+    }
+
+    /// Histogram of times of sources and the slowest of them (not for the whole document).
+    void latency(RunStats& run) const;
+
+    /// Checks if matches are sent to the sink one by one (could be split into pages).
+    [[nodiscard]] bool streamed() const noexcept {
+        return granularity_ not_eq Granularity::Count and granularity_ not_eq Granularity::GroupBy;
+    }
+
+    Granularity const granularity_;
+    std::vector<Subject> const subjects_;
+    int const group_;
+    std::vector<Pattern> patterns_{};
+    std::vector<Ref> refs_{};
+    isize limit_{};
+    isize budget_{};    // how many matches can be still sent on this page
+    Cursor cursor_{};
+    Tally tally_{};
+    isize found_{};
+    isize result_bytes_{};  // estimate of what was sent to the sink
+    std::vector<Clock::duration> latency_{};    // time of the engine on every source (with all patterns)
+    bool counted_{};        // hardware counters were available for the scan
+    Pending pending_{};
+    bool held_{};           // the pending generator holds the next match (pulled before the page was ended)
+    TopK counts_{};
+    static constexpr std::size_t TopCount = 20;
+    static constexpr std::size_t SlowestCount = 10;
+    static constexpr double HistogramBase = 4.0;    // ratio of bounds of buckets (from 1 us)
+    static constexpr int HistogramSize = 12;
+    static constexpr isize ClockStep = 64;     // matches between checks of the time slice
+    static constexpr isize SampleStrata = 16;
+    static constexpr u64 SampleSeed = 0x5eed;
+};
@@ -0,0 +1,117 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include <cstddef>
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
+/*------- vectorized scans of text:
+-------------------------------------------------------------------*/
+namespace simd {
+    /// Checks if all bytes are ASCII (16 bytes in one step).
+    inline bool is_ascii(char const* const data, std::size_t const n) noexcept {
+        std::size_t i{};
+#if defined(__SSE2__)
+        for (; i + 16 <= n; i += 16) {
+            auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i));
+            if (_mm_movemask_epi8(v))
+                return false;
+        }
+#elif defined(__ARM_NEON)
+        for (; i + 16 <= n; i += 16) {
+            auto const v = vld1q_u8(reinterpret_cast<uint8_t const*>(data + i));
+            if (vmaxvq_u8(v) >= 0x80)
+                return false;
+        }
+#endif
+        for (; i < n; ++i)
+            if (u8(data[i]) >= 0x80)
+                return false;
+        return true;
+    }
+
+    /// Checks if all UTF-16 code units are ASCII (8 units in one step).
+    inline bool is_ascii(char16_t const* const data, std::size_t const n) noexcept {
+        std::size_t i{};
+#if defined(__SSE2__)
+        auto const mask = _mm_set1_epi16(short(0xff80));
+        auto const zero = _mm_setzero_si128();
+        for (; i + 8 <= n; i += 8) {
+            auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, mask), zero)) not_eq 0xffff)
+                return false;
+        }
+#elif defined(__ARM_NEON)
+        for (; i + 8 <= n; i += 8) {
+            auto const v = vld1q_u16(reinterpret_cast<uint16_t const*>(data + i));
+            if (vmaxvq_u16(v) >= 0x80)
+                return false;
+        }
+#endif
+        for (; i < n; ++i)
+            if (data[i] >= 0x80)
+                return false;
+        return true;
+    }
+
+    inline bool is_ascii(qstr const& text) noexcept {
+        return is_ascii(reinterpret_cast<char16_t const*>(text.utf16()), std::size_t(text.size()));
+    }
+
+    /// Calls the function with the index of every '\n' (8 units in one step).
+    template<typename F>
+    inline void for_each_newline(char16_t const* const data, std::size_t const n, F&& f) {
+        std::size_t i{};
+#if defined(__SSE2__)
+        auto const nl = _mm_set1_epi16(short('\n'));
+        for (; i + 8 <= n; i += 8) {
+            auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i));
+            // Two mask bits for every code unit.
+            for (auto mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi16(v, nl))); mask; mask &= mask - 1)
+                if (auto const bit = unsigned(__builtin_ctz(mask)); (bit & 1) == 0)
+                    f(i + bit / 2);
+        }
+#elif defined(__ARM_NEON)
+        auto const nl = vdupq_n_u16(u'\n');
+        for (; i + 8 <= n; i += 8) {
+            auto const v = vld1q_u16(reinterpret_cast<uint16_t const*>(data + i));
+            if (vmaxvq_u16(vceqq_u16(v, nl)) == 0)
+                continue;
+            for (std::size_t j = i; j < i + 8; ++j)
+                if (data[j] == u'\n')
+                    f(j);
+        }
+#endif
+        for (; i < n; ++i)
+            if (data[i] == u'\n')
+                f(i);
+    }
+}
@@ -0,0 +1,228 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include "Trace.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <string_view>
+
+/*------- stages of the run:
+-------------------------------------------------------------------*/
+/// Time (and allocations) spent in stages of the path from the editors to highlights. \n
+/// Measuring is off by default (a scope costs two relaxed loads then), it is turned on by benchmarks
+/// and by builds with HEAP_PROFILE. Stages are also spans of the trace (when it is recording).
+/// Stages nest (e.g. Post is a part of Scan), times are inclusive.
+namespace stage {
+    enum Id {
+        Content,    // editors -> strings (WorkingWindow::content)
+        Prepare,    // subjects and compiled patterns (Workspace::prepare)
+        Scan,       // matching, formatting of lines, posting to the matches-view
+        Post,       // lines and matches posted as events (a part of Scan)
+        Serialize,  // matches written as JSON for the highlighter
+        Dispatch,   // events delivered by the controller (includes Append and Highlight)
+        Append,     // lines appended to the matches-view
+        Parse,      // JSON of matches read back (a part of Highlight)
+        Highlight,  // source-editor highlighted
+        Count
+    };
+    inline constexpr std::array<std::string_view, Count> Names{
+            "content", "prepare", "scan", "post", "serialize", "dispatch", "append", "parse", "highlight"};
+
+    struct Totals {
+        std::atomic<i64> ns{};
+        std::atomic<i64> calls{};
+        std::atomic<i64> allocations{};
+        std::atomic<i64> bytes{};
+        std::atomic<i64> peak{};
+    };
+
+    /// Copy of totals of one stage.
+    struct Snapshot {
+        i64 ns{};
+        i64 calls{};
+        i64 allocations{};
+        i64 bytes{};
+        i64 peak{};     // the highest of all calls
+    };
+
+    inline std::atomic<bool> enabled{};
+    inline std::array<Totals, Count> totals{};
+
+    /// The value is raised to at least n.
+    inline void raise(std::atomic<i64>& value, i64 const n) noexcept {
+        for (auto current = value.load(std::memory_order_relaxed);
+             n > current and not value.compare_exchange_weak(current, n, std::memory_order_relaxed);) {}
+    }
+
+    /// Allocations counted by the hook of the allocator (Heap.cc - benchmarks and HEAP_PROFILE builds). \n
+    /// Every thread counts its own allocations, so stages and runs on other threads do not disturb the numbers.
+    namespace heap {
+        inline std::atomic<bool> hooked{};          // set by the hook when the program starts
+        inline std::atomic<i64> allocations{};      // the whole process
+        inline std::atomic<i64> bytes{};
+
+        /// Allocations of one thread.
+        struct Thread {
+            i64 allocations{};
+            i64 bytes{};        // requested
+            i64 live{};         // allocated minus freed by the thread (other threads may free its memory)
+            i64 peak{};         // the highest live since the innermost probe started
+        };
+        inline constinit thread_local Thread local{};
+
+        /// Allocations of a part of the work (e.g. a stage or a pattern).
+        struct Usage {
+            i64 allocations{};
+            i64 bytes{};
+            i64 peak{};         // the highest growth of the heap above the start
+
+            Usage& operator+=(Usage const& other) noexcept {
+                allocations += other.allocations;
+                bytes += other.bytes;
+                peak = std::max(peak, other.peak);
+                return *this;
+            }
+        };
+
+        /// Called by the hook (must not allocate).
+        /// \param n - requested bytes,
+        /// \param size - bytes really taken from the heap.
+        inline void allocated(std::size_t const n, std::size_t const size) noexcept {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+            bytes.fetch_add(i64(n), std::memory_order_relaxed);
+            auto& t = local;
+            ++t.allocations;
+            t.bytes += i64(n);
+            t.live += i64(size);
+            t.peak = std::max(t.peak, t.live);
+        }
+        /// Called by the hook (must not allocate).
+        /// \param size - bytes returned to the heap.
+        inline void freed(std::size_t const size) noexcept {
+            local.live -= i64(size);
+        }
+
+        /// Allocations of the current thread since the creation of the probe (or since the last take). \n
+        /// Probes nest (as stages do) - the peak of the outer probe includes peaks of inner ones.
+        class Probe {
+            Thread start_{};
+            i64 outer_{};       // the peak before the probe (restored at the end)
+            i64 highest_{};     // the peak of takes
+        public:
+            Probe() noexcept :
+                outer_{local.peak}
+            {
+                restart();
+            }
+            ~Probe() {
+                local.peak = std::max({outer_, highest_, local.peak});
+            }
+            Probe(Probe const&) = delete;
+            Probe& operator=(Probe const&) = delete;
+
+            /// Allocations since the start (or the last take), the next take counts from now.
+            Usage take() noexcept {
+                Usage const usage{
+                    .allocations = local.allocations - start_.allocations,
+                    .bytes = local.bytes - start_.bytes,
+                    .peak = local.peak - start_.live};
+                highest_ = std::max(highest_, local.peak);
+                restart();
+                return usage;
+            }
+
+        private:
+            void restart() noexcept {
+                local.peak = local.live;
+                start_ = local;
+            }
+        };
+    }
+
+    /// Measures the stage from its creation to its destruction.
+    class Scope {
+        using clock = std::chrono::steady_clock;
+        Id id_;
+        bool on_;
+        bool traced_;
+        clock::time_point start_{};
+        std::optional<heap::Probe> heap_{};
+    public:
+        explicit Scope(Id const id) noexcept :
+            id_{id},
+            on_{enabled.load(std::memory_order_relaxed)},
+            traced_{trace::recording.load(std::memory_order_relaxed)}
+        {
+            if (on_)
+                heap_.emplace();
+            if (on_ or traced_)
+                start_ = clock::now();
+        }
+        ~Scope() {
+            if (not on_ and not traced_)
+                return;
+            auto const end = clock::now();
+            if (on_) {
+                auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start_).count();
+                auto const usage = heap_->take();
+                auto& t = totals[id_];
+                t.ns.fetch_add(ns, std::memory_order_relaxed);
+                t.calls.fetch_add(1, std::memory_order_relaxed);
+                t.allocations.fetch_add(usage.allocations, std::memory_order_relaxed);
+                t.bytes.fetch_add(usage.bytes, std::memory_order_relaxed);
+                raise(t.peak, usage.peak);
+            }
+            // After the measurement - the span is not counted in the stage.
+            if (traced_)
+                trace::record(std::string(Names[id_]), "stage", start_, end);
+        }
+        Scope(Scope const&) = delete;
+        Scope& operator=(Scope const&) = delete;
+    };
+
+    /// Zero all totals (next measurement).
+    inline void reset() noexcept {
+        for (auto& t : totals) {
+            t.ns.store(0, std::memory_order_relaxed);
+            t.calls.store(0, std::memory_order_relaxed);
+            t.allocations.store(0, std::memory_order_relaxed);
+            t.bytes.store(0, std::memory_order_relaxed);
+            t.peak.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    inline Snapshot snapshot(Id const id) noexcept {
+        auto const& t = totals[id];
+        return {t.ns.load(std::memory_order_relaxed), t.calls.load(std::memory_order_relaxed),
+                t.allocations.load(std::memory_order_relaxed), t.bytes.load(std::memory_order_relaxed),
+                t.peak.load(std::memory_order_relaxed)};
+    }
+}
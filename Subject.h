@@ -0,0 +1,220 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include "Utf8Map.h"
+#include "Simd.h"
+#include "LineIndex.h"
+#include "model/Match.h"
+#include <optional>
+#include <string>
+#include <string_view>
+#include <fmt/core.h>
+
+/*------- subject classes:
+-------------------------------------------------------------------*/
+/// What one subject contains.
+enum class Scope {
+    Line,       // one line of the source
+    Document,   // the whole source (matches may span lines)
+};
+
+/// Source text for the 8-bit engines (std::regex, PCRE2-8) - UTF-8 bytes of the source line. \n
+/// Engines report byte positions, they are translated to QString positions for highlighting.
+class Utf8Subject {
+public:
+    enum class Kind {
+        Text,   // UTF-8 text
+        Bytes,  // any bytes (displayed with escapes)
+    };
+
+    /// \param text - the source line (or the whole source),
+    /// \param line - number of the line in the source-editor,
+    /// \param kind - how to treat the content,
+    /// \param scope - line or the whole document.
+    explicit Utf8Subject(qstr const& text, int const line, Kind const kind = Kind::Text, Scope const scope = Scope::Line) :
+        bytes_{text.toStdString()},
+        map_{bytes_},
+        line_{line},
+        kind_{kind}
+    {
+        if (scope == Scope::Document)
+            index_.emplace(text);
+    }
+
+    [[nodiscard]] int line() const noexcept { return line_; }
+    [[nodiscard]] bool ascii() const noexcept { return map_.identity(); }
+    /// The subject is the whole document (not one line).
+    [[nodiscard]] bool document() const noexcept { return index_.has_value(); }
+
+    [[nodiscard]] char const* data() const noexcept { return bytes_.data(); }
+    [[nodiscard]] std::size_t size() const noexcept { return bytes_.size(); }
+
+    /// Part of the subject (e.g. a line of the document) as a line subject of its own.
+    /// \param start, length - the part in bytes (it must not split a character),
+    /// \param line - number of the line in the source-editor.
+    [[nodiscard]] Utf8Subject part(isize const start, isize const length, int const line) const {
+        return Utf8Subject(qstr::fromUtf8(bytes_.data() + start, length), line, kind_);
+    }
+
+    /// Lazy matches of the expression in this subject.
+    template<typename Engine>
+    [[nodiscard]] auto matches(Engine const& rgx) const {
+        return rgx.matches(data(), size());
+    }
+
+    /// Groups of the match at the offset.
+    template<typename Engine>
+    [[nodiscard]] Spans groups_at(Engine const& rgx, isize const offset) const {
+        return rgx.groups_at(data(), size(), std::size_t(offset));
+    }
+
+    /// Matched text for display.
+    [[nodiscard]] std::string shown(isize const start, isize const length) const noexcept {
+        auto const text = std::string_view(bytes_).substr(start, length);
+        return kind_ == Kind::Bytes ? escaped(text) : std::string(text);
+    }
+
+    /// Match position for highlighting (QString positions, without string). \n
+    /// In a document the position is found in the line-offset table.
+    [[nodiscard]] Match span(int const nr, isize const start, isize const length) const noexcept {
+        auto const [pos, len] = map_.to_utf16(start, length);
+        if (index_) {
+            auto const [line, column] = index_->locate(pos);
+            return Match{.line = line, .nr = nr, .pos = int(column), .length = int(len)};
+        }
+        return Match{.line = line_, .nr = nr, .pos = int(pos), .length = int(len)};
+    }
+
+    /// Match description for highlighting (QString positions, valid UTF-8 string).
+    [[nodiscard]] Match match(int const nr, isize const start, isize const length) const noexcept {
+        auto const text = std::string_view(bytes_).substr(start, length);
+        auto m = span(nr, start, length);
+        // In byte mode a match may split a multibyte character.
+        m.str = kind_ == Kind::Bytes
+                ? qstr::fromUtf8(text.data(), isize(text.size())).toStdString()
+                : std::string(text);
+        return m;
+    }
+
+    /// Bytes for display - printable ASCII as is, everything else as \xNN.
+    static std::string escaped(std::string_view const data) noexcept {
+        std::string text;
+        text.reserve(data.size());
+        for (auto const c : data) {
+            if (auto const b = u8(c); b >= 0x20 and b < 0x7f)
+                text.push_back(c);
+            else
+                text += fmt::format("\\x{:02x}", b);
+        }
+        return text;
+    }
+
+private:
+    std::string bytes_;
+    Utf8Map map_;
+    int line_;
+    Kind kind_;
+    std::optional<LineIndex> index_{};
+};
+
+/// Source text for the UTF-16 engines (PCRE2-16, Qt) - QString data without transcoding. \n
+/// Engines report QString positions, highlighting uses them as they are.
+class Utf16Subject {
+    qstr text_;
+    int line_;
+    bool ascii_;
+    std::optional<LineIndex> index_{};
+public:
+    /// \param text - the source line (or the whole source),
+    /// \param line - number of the line in the source-editor,
+    /// \param scope - line or the whole document.
+    Utf16Subject(qstr text, int const line, Scope const scope = Scope::Line) :
+        text_{std::move(text)},
+        line_{line},
+        ascii_{simd::is_ascii(text_)}
+    {
+        if (scope == Scope::Document)
+            index_.emplace(text_);
+    }
+
+    [[nodiscard]] int line() const noexcept { return line_; }
+    [[nodiscard]] bool ascii() const noexcept { return ascii_; }
+    /// The subject is the whole document (not one line).
+    [[nodiscard]] bool document() const noexcept { return index_.has_value(); }
+
+    [[nodiscard]] qstr const& text() const noexcept { return text_; }
+    [[nodiscard]] char16_t const* data() const noexcept { return reinterpret_cast<char16_t const*>(text_.utf16()); }
+    [[nodiscard]] std::size_t size() const noexcept { return std::size_t(text_.size()); }
+
+    /// Part of the subject (e.g. a line of the document) as a line subject of its own.
+    /// \param start, length - the part in QString positions,
+    /// \param line - number of the line in the source-editor.
+    [[nodiscard]] Utf16Subject part(isize const start, isize const length, int const line) const {
+        return Utf16Subject(text_.mid(start, length), line);
+    }
+
+    /// Lazy matches of the expression in this subject.
+    template<typename Engine>
+    [[nodiscard]] auto matches(Engine const& rgx) const {
+        if constexpr (requires { rgx.matches(text_); })
+            return rgx.matches(text_);
+        else
+            return rgx.matches(data(), size());
+    }
+
+    /// Groups of the match at the offset.
+    template<typename Engine>
+    [[nodiscard]] Spans groups_at(Engine const& rgx, isize const offset) const {
+        if constexpr (requires { rgx.groups_at(text_, offset); })
+            return rgx.groups_at(text_, offset);
+        else
+            return rgx.groups_at(data(), size(), std::size_t(offset));
+    }
+
+    /// Matched text for display.
+    [[nodiscard]] std::string shown(isize const start, isize const length) const noexcept {
+        return text_.mid(start, length).toStdString();
+    }
+
+    /// Match position for highlighting (without string). \n
+    /// In a document the position is found in the line-offset table.
+    [[nodiscard]] Match span(int const nr, isize const start, isize const length) const noexcept {
+        if (index_) {
+            auto const [line, column] = index_->locate(start);
+            return Match{.line = line, .nr = nr, .pos = int(column), .length = int(length)};
+        }
+        return Match{.line = line_, .nr = nr, .pos = int(start), .length = int(length)};
+    }
+
+    /// Match description for highlighting.
+    [[nodiscard]] Match match(int const nr, isize const start, isize const length) const noexcept {
+        auto m = span(nr, start, length);
+        m.str = shown(start, length);
+        return m;
+    }
+};
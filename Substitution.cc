@@ -0,0 +1,131 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Substitution.h"
+#include <fmt/core.h>
+#include <utility>
+
+namespace {
+    /// UTF-8 of the text (the string is reused).
+    void utf8(QStringView const text, std::string& out) {
+        auto const bytes = text.toUtf8();
+        out.assign(bytes.constData(), std::size_t(bytes.size()));
+    }
+}
+
+Substitution::Substitution(qstr input, std::unique_ptr<BufferedFile> output, isize const preview) :
+    input_{std::move(input)},
+    output_{std::move(output)},
+    preview_{preview}
+{}
+
+void Substitution::reset(isize) {
+    position_ = 0;
+    lines_ = changed_ = replaced_ = 0;
+    done_ = false;
+}
+
+bool Substitution::next_line() noexcept {
+    if (position_ >= input_.size())
+        return false;
+    auto end = input_.indexOf('\n', position_);
+    if (end < 0)
+        end = input_.size();
+    view_ = QStringView(input_).sliced(position_, end - position_);
+    position_ = end + 1;
+    return true;
+}
+
+std::pair<std::string_view, isize> Substitution::rewrite() {
+    utf8(view_, line_);
+    std::string_view text = line_;
+    isize n{};
+    for (auto const& pattern : patterns_) {
+        next_.clear();
+        if (auto const k = pattern.rewrite(text, next_); k) {
+            n += k;
+            std::swap(current_, next_);
+            text = current_;
+        }
+    }
+    return {text, n};
+}
+
+std::pair<std::string_view, isize> Substitution::rewrite_qt() {
+    // QRegularExpression works on QString - only the result is converted to UTF-8.
+    qline_ = view_.toString();
+    auto text = &qline_;
+    isize n{};
+    for (auto const& pattern : patterns_)
+        if (auto const k = pattern.qt_rewrite(*text, qnext_); k) {
+            n += k;
+            std::swap(qcurrent_, qnext_);
+            text = &qcurrent_;
+        }
+    utf8(*text, current_);
+    return {current_, n};
+}
+
+Run::Status Substitution::advance(Sink& sink, Clock::time_point const deadline) {
+    if (done_)
+        return Status::Done;
+    auto const timed = deadline not_eq Clock::time_point::max();
+
+    for (isize i = 1; ; ++i) {
+        if (timed and i % ClockStep == 0 and Clock::now() >= deadline)
+            return Status::Slice;
+        if (not next_line())
+            break;
+        ++lines_;
+
+        auto const [text, n] = qt_ ? rewrite_qt() : rewrite();
+        output_->write(text);
+        // The last line without the line end stays without it.
+        if (position_ <= input_.size())
+            output_->write("\n");
+
+        if (n) {
+            if (replaced_ < preview_) {
+                if (qt_)
+                    utf8(view_, line_);
+                sink.line(fmt::format("-{}: {}", lines_, line_));
+                sink.line(fmt::format("+{}: {}", lines_, text));
+                if (replaced_ + n >= preview_)
+                    sink.line(fmt::format("... preview ends after {} replacements ...", replaced_ + n));
+            }
+            replaced_ += n;
+            ++changed_;
+        }
+    }
+
+    done_ = true;
+    sink.line(fmt::format("=== {} replacements in {} of {} lines ===", replaced_, changed_, lines_));
+    output_->flush();
+    sink.line(output_->valid()
+              ? fmt::format("=== {} bytes written ===", output_->size())
+              : std::string("=== ERROR: the result could not be written (disk full?) ==="));
+    return Status::Done;
+}
@@ -0,0 +1,120 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include "Search.h"
+#include "ExportSink.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// Search-and-replace of all patterns (one after another) in every line of the input. \n
+/// The input is read and the result is written line by line, so memory does not depend
+/// on the size of the data. Only the first replacements are shown (diff preview),
+/// the full result goes to the file (a temporary one for a new tab).
+class Substitution : public Run {
+public:
+    /// Rewriting of one line by one pattern - the result is appended to out.
+    /// \return number of replacements.
+    using Rewrite = std::function<isize(std::string_view line, std::string& out)>;
+    /// Rewriting of one QString line by one pattern - out is the result (if anything was replaced).
+    /// \return number of replacements.
+    using QtRewrite = std::function<isize(qstr const& line, qstr& out)>;
+
+    /// \param input - the source text (shared, not copied - lines are converted to UTF-8 one by one),
+    /// \param output - the file for the result,
+    /// \param preview - number of replacements shown in the diff preview.
+    Substitution(qstr input, std::unique_ptr<BufferedFile> output, isize preview);
+
+    /// Add pattern with its rewriting.
+    void add(qstr text, Rewrite rewrite) noexcept {
+        patterns_.push_back(Pattern{.text = std::move(text), .rewrite = std::move(rewrite)});
+    }
+    /// Add pattern with its rewriting of QString lines (all patterns of the substitution must be of this kind) -
+    /// lines are converted to UTF-8 only after all patterns.
+    void add(qstr text, QtRewrite rewrite) noexcept {
+        patterns_.push_back(Pattern{.text = std::move(text), .qt_rewrite = std::move(rewrite)});
+        qt_ = true;
+    }
+
+    void reset(isize limit) override;
+    void next_page() override {}
+    Status advance(Sink& sink, Clock::time_point deadline) override;
+    void sample(Sink&, isize) override {}
+    [[nodiscard]] strings groups(int) const override {
+        return {};
+    }
+    /// Number of replacements.
+    [[nodiscard]] isize found() const noexcept override {
+        return replaced_;
+    }
+
+    /// The file with the result (e.g. the temporary one to be loaded into a new tab).
+    [[nodiscard]] std::unique_ptr<BufferedFile> take_output() noexcept {
+        return std::move(output_);
+    }
+
+private:
+    struct Pattern {
+        qstr text;
+        Rewrite rewrite{};
+        QtRewrite qt_rewrite{};
+    };
+
+    /// The next line of the input goes to view_.
+    /// \return false at the end of the input.
+    bool next_line() noexcept;
+    /// Every pattern rewrites the result of the previous one (UTF-8 lines).
+    /// \return the result (UTF-8) and number of replacements.
+    std::pair<std::string_view, isize> rewrite();
+    /// Every pattern rewrites the result of the previous one (QString lines).
+    std::pair<std::string_view, isize> rewrite_qt();
+
+    qstr const input_;
+    qsizetype position_{};
+    std::unique_ptr<BufferedFile> output_;
+    isize preview_;
+    std::vector<Pattern> patterns_{};
+    bool qt_{};
+    QStringView view_{};
+    qstr qline_{};
+    qstr qcurrent_{};
+    qstr qnext_{};
+    std::string line_{};
+    std::string current_{};
+    std::string next_{};
+    isize lines_{};
+    isize changed_{};
+    isize replaced_{};
+    bool done_{};
+    static constexpr isize ClockStep = 64;
+};
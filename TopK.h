@@ -0,0 +1,131 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include <algorithm>
+#include <functional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// Streaming counter of values (Space-Saving heavy hitters). \n
+/// Keeps at most 'capacity' counters - memory is bounded however many values come.
+/// While the number of distinct values does not exceed the capacity the counts are exact,
+/// later the least frequent value is replaced and its count is the error bound of the newcomer.
+class TopK {
+public:
+    /// One counted value.
+    struct Item {
+        std::string value;
+        isize count;
+        isize error;    // the count may be overestimated at most by this
+    };
+
+    explicit TopK(std::size_t const capacity = DefaultCapacity) :
+        capacity_{std::max<std::size_t>(capacity, 1)}
+    {
+        counters_.reserve(capacity_);
+    }
+
+    /// Count the value.
+    void add(std::string_view const value) {
+        ++total_;
+        if (auto const it = counters_.find(value); it not_eq counters_.end()) {
+            bump(it->first, it->second, it->second.count + 1);
+            return;
+        }
+        if (counters_.size() < capacity_) {
+            auto const [it, _] = counters_.emplace(std::string(value), Counter{1, 0});
+            order_.emplace(1, it->first);
+            return;
+        }
+        // Full - the least frequent value gives its counter to the newcomer.
+        ++evicted_;
+        auto const min = order_.begin();
+        auto const count = min->first;
+        counters_.erase(counters_.find(min->second));
+        order_.erase(min);
+        auto const [it, _] = counters_.emplace(std::string(value), Counter{count + 1, count});
+        order_.emplace(count + 1, it->first);
+    }
+
+    /// The most frequent values (descending count).
+    [[nodiscard]] std::vector<Item> top(std::size_t const k) const {
+        std::vector<Item> items;
+        items.reserve(std::min(k, order_.size()));
+        for (auto it = order_.crbegin(); it not_eq order_.crend() and items.size() < k; ++it) {
+            auto const& counter = counters_.find(it->second)->second;
+            items.push_back(Item{std::string(it->second), counter.count, counter.error});
+        }
+        return items;
+    }
+
+    /// Checks if all counts are exact (no counter was ever replaced).
+    [[nodiscard]] bool exact() const noexcept {
+        return evicted_ == 0;
+    }
+    /// Number of counted values (all, not distinct).
+    [[nodiscard]] isize total() const noexcept {
+        return total_;
+    }
+    /// Number of distinct values (exact only if exact()).
+    [[nodiscard]] std::size_t distinct() const noexcept {
+        return counters_.size();
+    }
+
+    static constexpr std::size_t DefaultCapacity = 1024;
+private:
+    struct Counter {
+        isize count;
+        isize error;
+    };
+    /// Hash which finds std::string keys with string_view (no allocation for known values).
+    struct Hash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view const text) const noexcept {
+            return std::hash<std::string_view>{}(text);
+        }
+    };
+
+    void bump(std::string_view const key, Counter& counter, isize const count) {
+        order_.erase(order_.find({counter.count, key}));
+        counter.count = count;
+        order_.emplace(count, key);
+    }
+
+    std::size_t capacity_;
+    isize total_{};
+    isize evicted_{};
+    // Keys of the set point into the map nodes (they do not move on rehash).
+    std::unordered_map<std::string, Counter, Hash, std::equal_to<>> counters_{};
+    std::set<std::pair<isize, std::string_view>> order_{};
+};
@@ -0,0 +1,218 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Trace.h"
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <fmt/core.h>
+#include <glaze/glaze.hpp>
+
+namespace trace {
+    namespace {
+        struct Record {
+            std::string name;
+            char const* category;
+            clock::time_point begin;
+            clock::time_point end;
+            Args args;
+        };
+
+        /// Spans of one thread (kept after the thread ends until the next start).
+        struct Thread {
+            u32 id{};
+            std::string name{};
+            std::mutex mutex{};
+            std::vector<Record> records{};
+        };
+
+        struct Registry {
+            std::mutex mutex{};
+            std::vector<std::shared_ptr<Thread>> threads{};
+            u32 next_id{1};
+            clock::time_point origin{clock::now()};
+            std::atomic<isize> count{};
+            std::atomic<isize> dropped{};
+        };
+
+        /// Event in the Chrome trace-event format (X - complete span, M - metadata).
+        struct Event {
+            std::string name{};
+            std::string cat{};
+            std::string ph{};
+            double ts{};    // microseconds
+            double dur{};
+            int pid{};
+            u32 tid{};
+            Args args{};
+        };
+
+        constexpr isize Capacity = 1'000'000;
+        constexpr int Pid = 1;
+        constexpr std::size_t Chunk = 1 << 20;
+
+        Registry& registry() noexcept {
+            static Registry instance;
+            return instance;
+        }
+
+        /// Buffer of the current thread (registered at the first use).
+        Thread& local() {
+            thread_local std::shared_ptr<Thread> const thread = [] {
+                auto& r = registry();
+                auto buffer = std::make_shared<Thread>();
+                std::lock_guard lock(r.mutex);
+                buffer->id = r.next_id++;
+                r.threads.push_back(buffer);
+                return buffer;
+            }();
+            return *thread;
+        }
+
+        double us(clock::duration const d) noexcept {
+            return std::chrono::duration<double, std::micro>(d).count();
+        }
+    }
+}
+
+/*------- glaze template:
+-------------------------------------------------------------------*/
+template<>
+struct glz::meta<trace::Event> {
+    using T = trace::Event;
+    static constexpr auto value = object(
+            "name", &T::name,
+            "cat", &T::cat,
+            "ph", &T::ph,
+            "ts", &T::ts,
+            "dur", &T::dur,
+            "pid", &T::pid,
+            "tid", &T::tid,
+            "args", &T::args
+    );
+};
+
+/*------- implementation:
+-------------------------------------------------------------------*/
+namespace trace {
+    void start() noexcept {
+        auto& r = registry();
+        std::lock_guard lock(r.mutex);
+        // Buffers of ended threads are not needed any more.
+        std::erase_if(r.threads, [](auto const& thread) { return thread.use_count() == 1; });
+        for (auto const& thread : r.threads) {
+            std::lock_guard records(thread->mutex);
+            thread->records.clear();
+        }
+        r.count = 0;
+        r.dropped = 0;
+        r.origin = clock::now();
+        recording = true;
+    }
+
+    void stop() noexcept {
+        recording = false;
+    }
+
+    void name_thread(std::string name) noexcept {
+        try {
+            auto& thread = local();
+            std::lock_guard lock(thread.mutex);
+            thread.name = std::move(name);
+        }
+        catch (...) {}
+    }
+
+    void record(std::string name, char const* const category,
+                clock::time_point const begin, clock::time_point const end, Args args) noexcept {
+        if (not recording.load(std::memory_order_relaxed))
+            return;
+        auto& r = registry();
+        if (r.count.fetch_add(1, std::memory_order_relaxed) >= Capacity) {
+            r.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        try {
+            auto& thread = local();
+            std::lock_guard lock(thread.mutex);
+            thread.records.push_back({std::move(name), category, begin, end, std::move(args)});
+        }
+        catch (...) {
+            r.dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    bool write(std::string const& path) noexcept {
+        auto const file = std::fopen(path.c_str(), "wb");
+        if (not file)
+            return false;
+        auto& r = registry();
+        std::string buffer;
+        auto failed = false;
+        auto const flush = [&] {
+            failed = failed or std::fwrite(buffer.data(), 1, buffer.size(), file) not_eq buffer.size();
+            buffer.clear();
+        };
+        auto first = true;
+        auto const put = [&](Event const& event) {
+            buffer += first ? "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" : ",\n";
+            first = false;
+            buffer += glz::write_json(event);
+            // A trace may have a million of spans - they are written in pieces.
+            if (buffer.size() >= Chunk)
+                flush();
+        };
+
+        try {
+            std::lock_guard lock(r.mutex);
+            put({.name = "process_name", .ph = "M", .pid = Pid, .args = {{"name", "ccregex"}}});
+            for (auto const& thread : r.threads) {
+                std::lock_guard records(thread->mutex);
+                auto const title = thread->name.empty() ? fmt::format("thread {}", thread->id) : thread->name;
+                put({.name = "thread_name", .ph = "M", .pid = Pid, .tid = thread->id, .args = {{"name", title}}});
+                for (auto const& [name, category, begin, end, args] : thread->records)
+                    put({.name = name,
+                         .cat = category,
+                         .ph = "X",
+                         .ts = us(begin - r.origin),
+                         .dur = us(end - begin),
+                         .pid = Pid,
+                         .tid = thread->id,
+                         .args = args});
+            }
+            if (auto const dropped = r.dropped.load(); dropped)
+                put({.name = fmt::format("{} spans dropped (the limit is {})", dropped, Capacity),
+                     .cat = "trace", .ph = "i", .pid = Pid});
+            buffer += "\n]}\n";
+        }
+        catch (...) {
+            failed = true;
+        }
+        flush();
+        return std::fclose(file) == 0 and not failed;
+    }
+}
@@ -0,0 +1,89 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+
+/*------- trace of runs:
+-------------------------------------------------------------------*/
+/// Spans of the work of all threads (stages, compilation, matching of every pattern and source)
+/// written as Chrome trace-event JSON - for Perfetto (ui.perfetto.dev) or chrome://tracing. \n
+/// Recording is off by default (a span costs one relaxed load then), it is started and stopped by the user.
+/// Every thread records to its own buffer, the number of spans is limited (the rest is dropped).
+namespace trace {
+    using clock = std::chrono::steady_clock;
+    /// Arguments of the span shown by the viewer (e.g. the pattern or the line).
+    using Args = std::map<std::string, std::string>;
+
+    inline std::atomic<bool> recording{};
+
+    /// Forget recorded spans and start recording.
+    void start() noexcept;
+    /// Stop recording (spans are kept for write).
+    void stop() noexcept;
+
+    /// Name of the current thread in the trace (e.g. gui, worker 1).
+    void name_thread(std::string name) noexcept;
+
+    /// Add the span of the current thread (if recording).
+    /// \param name - name of the span,
+    /// \param category - group of spans (e.g. stage, match),
+    /// \param begin, end - time of the span,
+    /// \param args - details of the span.
+    void record(std::string name, char const* category,
+                clock::time_point begin, clock::time_point end, Args args = {}) noexcept;
+
+    /// Write recorded spans of all threads to the file.
+    /// \return false if the file could not be written.
+    bool write(std::string const& path) noexcept;
+
+    /// Span from its creation to its destruction.
+    class Span {
+        char const* category_;
+        char const* name_;
+        bool on_;
+        clock::time_point begin_{};
+    public:
+        Span(char const* const category, char const* const name) noexcept :
+            category_{category},
+            name_{name},
+            on_{recording.load(std::memory_order_relaxed)}
+        {
+            if (on_)
+                begin_ = clock::now();
+        }
+        ~Span() {
+            if (on_)
+                record(name_, category_, begin_, clock::now());
+        }
+        Span(Span const&) = delete;
+        Span& operator=(Span const&) = delete;
+    };
+}
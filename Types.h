@@ -48,13 +48,16 @@ namespace tool {
 -------------------------------------------------------------------*/
 using i8 = qint8;
 using u8 = quint8;
+using u16 = quint16;
 using i32 = qint32;
 using u32 = quint32;
+using i64 = qint64;
 using u64 = quint64;
 using isize = qsizetype;
 using qstr = QString;
 using qvar = QVariant;
 using strings = std::vector<std::string>;
+using qstrings = QList<QString>;
 
 
 /*------- template types:
@@ -82,4 +85,20 @@ enum class ReadOnly {
     No,
     Yes,
 };
+/// What the user wants to know about matches (from the cheapest).
+enum class Granularity {
+    Any,        // only if a line matches (stop at the first match)
+    Count,      // only number of matches (no captures)
+    Offsets,    // positions of all groups (no strings)
+    Full,       // positions and strings of all groups
+    OnDemand,   // whole matches, groups are found when the user asks for them
+    GroupBy,    // counts of values of one group (table of the most frequent)
+};
+
+/// Position and length of a group (start is -1 if the group did not participate in the match).
+struct Span {
+    isize start{-1};
+    isize length{};
+};
+using Spans = std::vector<Span>;
 
@@ -0,0 +1,85 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Types.h"
+#include "Simd.h"
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// Precomputed map between byte offsets in UTF-8 text and offsets in UTF-16 code units. \n
+/// Offsets found by the 8-bit engines (std::regex, PCRE2-8) must be translated before
+/// they are used with QString (Highlighter, QString::mid).
+class Utf8Map {
+    /// UTF-16 offset for every byte offset (plus end of text). Empty for ASCII text.
+    std::vector<u32> units_{};
+public:
+    explicit Utf8Map(std::string_view const text) {
+        if (simd::is_ascii(text.data(), text.size()))
+            return;
+
+        units_.resize(text.size() + 1);
+        u32 unit{};
+        u32 lead{};
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            auto const c = u8(text[i]);
+            if ((c & 0xc0) not_eq 0x80) {
+                lead = unit;
+                // 4-byte sequences are encoded in UTF-16 as surrogate pairs.
+                unit += (c >= 0xf0) ? 2 : 1;
+            }
+            units_[i] = lead;
+        }
+        units_[text.size()] = unit;
+    }
+
+    /// Checks if the text is ASCII (offsets are the same in both encodings).
+    [[nodiscard]] bool identity() const noexcept {
+        return units_.empty();
+    }
+
+    /// Translate byte offset to UTF-16 offset.
+    [[nodiscard]] isize to_utf16(isize const byte) const noexcept {
+        if (identity()) return byte;
+        return units_[std::clamp<isize>(byte, 0, isize(units_.size()) - 1)];
+    }
+
+    /// Translate UTF-16 offset to byte offset (first byte of the character).
+    [[nodiscard]] isize to_utf8(isize const unit) const noexcept {
+        if (identity()) return unit;
+        auto const it = std::lower_bound(units_.cbegin(), units_.cend(), u32(unit));
+        return std::distance(units_.cbegin(), it);
+    }
+
+    /// Translate span (position and length in bytes) to UTF-16 span.
+    [[nodiscard]] std::pair<isize, isize> to_utf16(isize const pos, isize const length) const noexcept {
+        auto const begin = to_utf16(pos);
+        return {begin, to_utf16(pos + length) - begin};
+    }
+};
@@ -25,10 +25,38 @@
 #include "Settings.h"
 #include "WorkingWindow.h"
 #include "LabeledEditor.h"
+#include "MetricsPanel.h"
+#include "Scheduler.h"
+#include "ExportSink.h"
+#include "Substitution.h"
+#include "EventController.h"
 #include <QSplitter>
 #include <QHBoxLayout>
 #include <QFileInfo>
+#include <QTimer>
+#include <QStringDecoder>
+#include <algorithm>
+#include <cmath>
 #include <utility>
+#include <fmt/core.h>
+
+#ifdef HEAP_PROFILE
+namespace {
+    /// Stages measured since the previous call (the measurement starts again).
+    std::vector<StageStats> stages() {
+        std::vector<StageStats> buffer;
+        for (int id = 0; id < stage::Count; ++id)
+            if (auto const s = stage::snapshot(stage::Id(id)); s.calls)
+                buffer.push_back({
+                    .stage = std::string(stage::Names[id]),
+                    .calls = s.calls,
+                    .ms = double(s.ns) / 1e6,
+                    .heap = {.count = s.allocations, .bytes = s.bytes, .peak = s.peak}});
+        stage::reset();
+        return buffer;
+    }
+}
+#endif
 
 /*------- class implementation:
 -------------------------------------------------------------------*/
@@ -38,6 +66,7 @@ WorkingWindow::WorkingWindow(qstr path, qstr name, QWidget *const parent) :
         regex_edit_{new LabeledEditor("Regular Expression")},
         source_edit_{new LabeledEditor("Source String", Highlighting::Yes)},
         matches_view_{new LabeledEditor("Matches", Highlighting::No, ReadOnly::Yes)},
+        metrics_{new MetricsPanel},
         path_{std::move(path)},
         name_{std::move(name)}
 {
@@ -50,6 +79,7 @@ WorkingWindow::WorkingWindow(qstr path, qstr name, QWidget *const parent) :
     splitter_->addWidget(source_edit_);
     splitter_->addWidget(regex_edit_);
     splitter_->addWidget(matches_view_);
+    splitter_->addWidget(metrics_);
     splitter_->setHandleWidth(Settings::NoHandle);
     splitter_->setContentsMargins(Settings::NoMargins);
     splitter_->setPalette(p);
@@ -63,9 +93,294 @@ WorkingWindow::WorkingWindow(qstr path, qstr name, QWidget *const parent) :
 
     name_ = path_.isEmpty() ? type::NoName : QFileInfo(path_).baseName();
     setWindowTitle(name_);
+
+    // Results go only to editors of this window.
+    sink_ = EventSink(matches_view_->editor(), source_edit_->editor());
+    // The slowest lines of the run are shown in the source.
+    metrics_->set_jump([editor = source_edit_->editor()](int const line) {
+        editor->show_line(line);
+    });
+    // Receiver of event::RunDone from the scheduler.
+    EventController::instance().track(this);
+}
+
+WorkingWindow::~WorkingWindow() {
+    cancel();
+}
+
+void WorkingWindow::cancel() noexcept {
+    load_result_ = false;
+    if (not task_)
+        return;
+    // Not waited for - a worker may be in the middle of a slice (a long line, a benchmark step).
+    // The task owns its run and sink, the sink stops posting and the worker drops the task.
+    task_->cancelled = true;
+    task_.reset();
+}
+
+void WorkingWindow::clear_matches() noexcept {
+    cancel();
+    slices_ = {};
+    matches_view_->set_details({});
+    matches_view_->clear();
+    metrics_->clear();
+    regex_edit_->editor()->heatmap({});
+    run_.reset();
+    sink_.clear();
+    stopped_ = false;
+}
+
+bool WorkingWindow::start(std::unique_ptr<Run> run, isize const limit, bool const sliced) noexcept {
+    cancel();
+    slices_ = {};
+    run_ = std::move(run);
+    sliced_ = sliced;
+    stopped_ = false;
+    if (not run_) {
+        // Nothing clears old highlights.
+        sink_.flush();
+        return false;
+    }
+    matches_view_->set_details([run = run_.get()](int const ref) {
+        return run->groups(ref);
+    });
+
+    if (sliced_) {
+        run_->reset(limit);
+        slices_ = run_->slices(sink_, Slice);
+        flushed_ = Run::Clock::now();
+        return true;
+    }
+    try {
+        stage::Scope const scope{stage::Scan};
+        stopped_ = run_->scan(sink_, limit);
+    }
+    catch (std::exception const& e) {
+        failed(e);
+    }
+    // Matches of all lines are highlighted at once.
+    sink_.flush();
+    measured();
+    return false;
+}
+
+void WorkingWindow::submit(std::unique_ptr<Run> run, isize const limit, Scheduler& scheduler, bool const foreground) noexcept {
+    cancel();
+    slices_ = {};
+    stopped_ = false;
+    sliced_ = false;
+    if (not run) {
+        sink_.flush();
+        return;
+    }
+    // The run and the sink belong to workers until event::RunDone.
+    run->reset(limit);
+    auto sink = std::make_unique<EventSink>(std::move(sink_));
+    auto const events = sink.get();
+    task_ = std::make_shared<Task>(std::move(run), std::move(sink), this, foreground);
+    events->stop_on(&task_->cancelled);
+    sink_ = EventSink(matches_view_->editor(), source_edit_->editor());
+    scheduler.submit(task_);
+}
+
+void WorkingWindow::export_to(std::unique_ptr<Run> run, std::unique_ptr<ExportSink> sink, Scheduler& scheduler) noexcept {
+    cancel();
+    slices_ = {};
+    stopped_ = false;
+    if (not run or not sink)
+        return;
+    sink_.line(fmt::format("=== exporting to '{}' ... ===", sink->path()));
+    run->reset(0);
+    task_ = std::make_shared<Task>(std::move(run), std::move(sink), this, true);
+    scheduler.submit(task_);
+}
+
+void WorkingWindow::substitute(std::unique_ptr<Substitution> run, Scheduler& scheduler) noexcept {
+    if (not run)
+        return;
+    clear_matches();
+    submit(std::move(run), 0, scheduler, true);
+    load_result_ = true;
+}
+
+void WorkingWindow::foreground(bool const flag) noexcept {
+    if (task_)
+        task_->foreground = flag;
+}
+
+void WorkingWindow::customEvent(QEvent* const event) {
+    if (int(event->type()) == event::RunDone) {
+        // Only the current task (the event of a cancelled one may still come).
+        if (task_ and task_->finished) {
+            if (auto const sink = dynamic_cast<EventSink*>(task_->sink.get()); sink) {
+                run_ = std::move(task_->run);
+                sink_ = std::move(*sink);
+                sink_.stop_on(nullptr);
+                stopped_ = task_->status == Run::Status::Limit;
+                matches_view_->set_details([run = run_.get()](int const ref) {
+                    return run->groups(ref);
+                });
+                // A failed substitution leaves the source as it is (the error is in the matches-view).
+                if (load_result_ and task_->error.empty())
+                    load_result();
+                load_result_ = false;
+                measured();
+            }
+            else if (auto const file = dynamic_cast<ExportSink*>(task_->sink.get()); file) {
+                if (not task_->error.empty())
+                    sink_.line(fmt::format("ERROR: {}", task_->error));
+                sink_.line(file->failed()
+                           ? fmt::format("=== export to '{}' failed (disk full?) ===", file->path())
+                           : fmt::format("=== exported {} matches to '{}' ({} bytes) ===",
+                                         file->count(), file->path(), file->bytes()));
+            }
+            task_.reset();
+        }
+        event->accept();
+        return;
+    }
+    QWidget::customEvent(event);
+}
+
+bool WorkingWindow::more() noexcept {
+    if (task_ or not run_ or not stopped_)
+        return false;
+
+    if (sliced_) {
+        run_->next_page();
+        slices_ = run_->slices(sink_, Slice);
+        return true;
+    }
+    try {
+        stage::Scope const scope{stage::Scan};
+        stopped_ = run_->more(sink_);
+    }
+    catch (std::exception const& e) {
+        failed(e);
+    }
+    sink_.flush();
+    measured();
+    return false;
+}
+
+bool WorkingWindow::slice() noexcept {
+    if (slices_.done())
+        return false;
+
+    try {
+        auto const status = [this] {
+            stage::Scope const scope{stage::Scan};
+            return slices_.next();
+        }();
+        if (status and *status == Run::Status::Slice) {
+            // Every highlighting redraws the document - not after every slice.
+            if (auto const now = Run::Clock::now(); now - flushed_ >= FlushInterval) {
+                sink_.flush();
+                flushed_ = now;
+            }
+            return true;
+        }
+        stopped_ = status and *status == Run::Status::Limit;
+    }
+    catch (std::exception const& e) {
+        failed(e);
+    }
+    slices_ = {};
+    sink_.flush();
+    measured();
+    return false;
+}
+
+void WorkingWindow::sample(std::unique_ptr<Run> const run, isize const size) noexcept {
+    if (not run)
+        return;
+    // The run on the scheduler is not needed any more (its sink is not ours).
+    cancel();
+    try {
+        run->sample(sink_, size);
+    }
+    catch (std::exception const& e) {
+        failed(e);
+    }
+    sink_.flush();
+}
+
+void WorkingWindow::failed(std::exception const& e) noexcept {
+    // e.g. std::regex_error (error_complexity, error_stack) thrown while matching.
+    sink_.line(fmt::format("ERROR: {}", e.what()));
+    stopped_ = false;
+}
+
+void WorkingWindow::measured() noexcept {
+    if (not run_)
+        return;
+#ifdef PCRE2_REGEX
+    if (auto const profiler = dynamic_cast<Profiler const*>(run_.get()); profiler)
+        heatmap(profiler->heat());
+#endif
+    auto stats = run_->stats();
+    if (stats.patterns.empty()) {
+        metrics_->clear();
+        return;
+    }
+    if (metrics_in_matches_) {
+        sink_.line("=== metrics ===");
+        for (auto const& line : stats.lines())
+            sink_.line(line);
+    }
+    metrics_->set(std::move(stats));
+#ifdef HEAP_PROFILE
+    // Stages are reported after the last events of the run (posted before the timer).
+    QTimer::singleShot(0, this, [this] {
+        metrics_->set_stages(stages());
+    });
+#endif
 }
 
-WorkingWindow::~WorkingWindow() = default;
+void WorkingWindow::load_result() noexcept {
+    auto const substitution = dynamic_cast<Substitution*>(run_.get());
+    if (not substitution)
+        return;
+    auto const file = substitution->take_output();
+    if (not file)
+        return;
+
+    // Chunk by chunk - the result is never in memory twice (the decoder keeps
+    // UTF-8 sequences split between chunks).
+    source_edit_->clear();
+    auto const editor = source_edit_->editor();
+    QStringDecoder utf8{QStringDecoder::Utf8};
+    auto const read = file->read([editor, &utf8](std::string_view const chunk) {
+        editor->append_text(utf8(QByteArrayView(chunk.data(), qsizetype(chunk.size()))));
+    });
+    if (not read)
+        sink_.line("=== ERROR: the result could not be read ===");
+}
+
+#ifdef PCRE2_REGEX
+void WorkingWindow::heatmap(std::vector<Profiler::Heat> const& heat) const noexcept {
+    isize hottest{};
+    for (auto const& pattern : heat)
+        for (auto const& spot : pattern.spots)
+            hottest = std::max(hottest, spot.visits);
+    if (hottest == 0)
+        return;
+
+    // Patterns are not empty lines of the editor, in the same order (and with the same trimming).
+    auto const lines = regex_blocks();
+    std::vector<Editor::Heat> spans;
+    for (std::size_t i = 0; i < lines.size() and i < heat.size(); ++i)
+        for (auto const& spot : heat[i].spots)
+            if (spot.length)
+                // Logarithmic - counts of hot spots are orders of magnitude bigger.
+                spans.push_back(Editor::Heat{
+                    .block = lines[i].block,
+                    .position = lines[i].offset + spot.position,
+                    .length = spot.length,
+                    .level = std::log1p(double(spot.visits)) / std::log1p(double(hottest))});
+    regex_edit_->editor()->heatmap(spans);
+}
+#endif
 
 void WorkingWindow::set_content(qstr path, Content const& content) noexcept {
     path_ = std::move(path);
@@ -96,3 +411,36 @@ std::vector<std::string> WorkingWindow::transform(qstr const& str) noexcept {
     }
     return buffer;
 }
+
+std::vector<WorkingWindow::RegexLine> WorkingWindow::regex_blocks() const noexcept {
+    std::vector<RegexLine> buffer;
+    auto const data = regex_edit_->content().split('\n');
+    for (int nr = 0; nr < data.size(); ++nr) {
+        auto const& line = data[nr];
+        if (line.trimmed().isEmpty())
+            continue;
+        // The first pattern starts the trimmed content.
+        isize offset{};
+        if (buffer.empty())
+            while (offset < line.size() and line[offset].isSpace())
+                ++offset;
+        buffer.push_back(RegexLine{.text = line.mid(offset), .block = nr, .offset = offset});
+    }
+    // The last one ends it.
+    if (not buffer.empty())
+        for (auto& text = buffer.back().text; text.back().isSpace();)
+            text.chop(1);
+    return buffer;
+}
+
+qstrings WorkingWindow::lines(qstr const& str) noexcept {
+    qstrings buffer;
+    if (not str.isEmpty()) {
+        auto data = str.split('\n');
+        buffer.reserve(data.size());
+        for (auto& item: data)
+            if (not item.trimmed().isEmpty())
+                buffer.push_back(std::move(item));
+    }
+    return buffer;
+}
@@ -29,14 +29,26 @@
 #include "Types.h"
 #include "Content.h"
 #include "LabeledEditor.h"
+#include "EventSink.h"
+#include "Search.h"
+#include "Stage.h"
+#ifdef PCRE2_REGEX
+    #include "Profiler.h"
+#endif
 #include <QWidget>
+#include <memory>
 #include <vector>
 #include <string>
 
 /*------- forward declarations:
 -------------------------------------------------------------------*/
 class LabeledEditor;
+class MetricsPanel;
 class QSplitter;
+class Scheduler;
+class ExportSink;
+class Substitution;
+struct Task;
 
 /*------- class declaration:
 -------------------------------------------------------------------*/
@@ -57,12 +69,42 @@ public:
 
     /// Return content of all editors.
     [[nodiscard]] Content content() const noexcept {
+        stage::Scope const scope{stage::Content};
         auto regex_content = transform(regex_edit_->content().trimmed());
         auto source_content = transform(source_edit_->content().trimmed());
         auto matches_content = transform(matches_view_->content().trimmed());
         return {regex_content, source_content, matches_content};
     }
 
+    /// Not empty line of the regex-editor and its place in the editor.
+    struct RegexLine {
+        qstr text;          // the pattern (as regex_lines returns it)
+        int block;          // number of the line in the editor
+        isize offset;       // position of the pattern in the line (whitespace trimmed at the start)
+    };
+    /// Return not empty lines of the regex-editor with their places in the editor
+    /// (the same patterns as regex_lines returns - the content trimmed as a whole).
+    [[nodiscard]] std::vector<RegexLine> regex_blocks() const noexcept;
+
+    /// Return not empty lines of the regex-editor (as they are, without conversion to std-strings).
+    [[nodiscard]] qstrings regex_lines() const noexcept {
+        qstrings buffer;
+        for (auto& line : regex_blocks())
+            buffer.push_back(std::move(line.text));
+        return buffer;
+    }
+
+    /// Return the whole content of the source-editor.
+    [[nodiscard]] qstr source_text() const noexcept {
+        return source_edit_->content();
+    }
+
+    /// Return all lines of the source-editor (as they are, without conversion to std-strings). \n
+    /// Empty lines are included - index of the line is the number of the block in the editor.
+    [[nodiscard]] qstrings source_lines() const noexcept {
+        return source_edit_->content().split('\n');
+    }
+
     /// Delete content in all editors.
     void clear() noexcept {
         regex_edit_->clear();
@@ -71,22 +113,109 @@ public:
     }
 
     /// Delete content of matches-editor (before run).
-    void clear_matches() noexcept {
-        matches_view_->clear();
+    void clear_matches() noexcept;
+
+    /// Scan with the run, results go to the matches-view. \n
+    /// The run is kept (groups of matches on demand, next pages).
+    /// \param run - prepared run (nullptr - only highlights are cleared),
+    /// \param limit - the scan stops after so many matches (0 - no limit),
+    /// \param sliced - the scan is done later in time slices (see slice).
+    /// \return true if the run waits for time slices.
+    bool start(std::unique_ptr<Run> run, isize limit, bool sliced) noexcept;
+
+    /// Next page of results of the kept run (if it stopped at the limit).
+    /// \return true if the page waits for time slices.
+    bool more() noexcept;
+
+    /// Scan with the run on the shared scheduler (worker threads). \n
+    /// Results are shown as they come, the run is taken back when it is done (event::RunDone).
+    /// \param run - prepared run (nullptr - only highlights are cleared),
+    /// \param limit - the scan stops after so many matches (0 - no limit),
+    /// \param scheduler - the shared scheduler,
+    /// \param foreground - the window is visible (its run goes first).
+    void submit(std::unique_ptr<Run> run, isize limit, Scheduler& scheduler, bool foreground) noexcept;
+
+    /// Export matches of the run to a file on the shared scheduler. \n
+    /// The matches-view shows only the summary, the run is not kept.
+    /// \param run - prepared run (nullptr - nothing to do),
+    /// \param sink - the opened export file,
+    /// \param scheduler - the shared scheduler.
+    void export_to(std::unique_ptr<Run> run, std::unique_ptr<ExportSink> sink, Scheduler& scheduler) noexcept;
+
+    /// Search-and-replace into the source-editor on the shared scheduler. \n
+    /// The preview goes to the matches-view, the result (the temporary file of the run)
+    /// is loaded into the source-editor when the run is done.
+    /// \param run - prepared substitution (nullptr - nothing to do),
+    /// \param scheduler - the shared scheduler.
+    void substitute(std::unique_ptr<Substitution> run, Scheduler& scheduler) noexcept;
+
+    /// The window became visible (or hidden) - priority of its run on the scheduler.
+    void foreground(bool flag) noexcept;
+
+    /// Measurements of finished runs are also appended to the matches-view.
+    void metrics_in_matches(bool const flag) noexcept {
+        metrics_in_matches_ = flag;
     }
 
+    /// Scan for one time slice (cooperative run on the GUI thread). \n
+    /// Lines go to the matches-view at once, highlights from time to time and at the end.
+    /// \return true if the run needs next slices.
+    bool slice() noexcept;
+
+    /// Estimate of the run from a sample of sources (the run is not kept).
+    /// \param run - prepared run (nullptr - nothing to do),
+    /// \param size - number of sampled sources.
+    void sample(std::unique_ptr<Run> run, isize size) noexcept;
+
     /// Transform editor's content from one QString to vectors of std-strings.
     static strings transform(qstr const& str) noexcept;
 
+    /// Split editor's content to not empty lines (the same lines as transform returns).
+    static qstrings lines(qstr const& str) noexcept;
+
     /// Return path (path works as identifier).
     [[nodiscard]] qstr const& path() const noexcept {
         return path_;
     }
+protected:
+    /// Handle events of the run on the scheduler (event::RunDone).
+    void customEvent(QEvent* event) override;
+
 private:
+    /// The run on the scheduler is not needed any more (new run, clear, close).
+    void cancel() noexcept;
+
+    /// Report the error of the scan in the matches-view (the run cannot continue).
+    void failed(std::exception const& e) noexcept;
+
+    /// The run (or its page) is finished - its measurements go to the metrics panel.
+    void measured() noexcept;
+
+    /// The result of the finished substitution replaces the content of the source-editor.
+    void load_result() noexcept;
+
+#ifdef PCRE2_REGEX
+    /// Heat of items of patterns over the regex-editor (the profile of backtracking).
+    void heatmap(std::vector<Profiler::Heat> const& heat) const noexcept;
+#endif
+
     QSplitter* const splitter_;
     LabeledEditor* const regex_edit_;
     LabeledEditor* const source_edit_;
     LabeledEditor* const matches_view_;
+    MetricsPanel* const metrics_;
+    std::unique_ptr<Run> run_{};
+    EventSink sink_{};
+    bool stopped_{};
+    bool sliced_{};
+    bool metrics_in_matches_{};
+    bool load_result_{};
+    // Destroyed before the run and the sink (it refers to them).
+    Generator<Run::Status> slices_{};
+    Run::Clock::time_point flushed_{};
+    std::shared_ptr<Task> task_{};
+    static constexpr auto Slice = std::chrono::milliseconds(4);
+    static constexpr auto FlushInterval = std::chrono::milliseconds(250);
 
     qstr path_{};
     qstr name_{};
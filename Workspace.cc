@@ -29,11 +29,30 @@
 #include "WorkingWindow.h"
 #include "Settings.h"
 #include "OptionsWidget.h"
+#include "Simd.h"
+#include "Subject.h"
+#include "RegexQt.h"
+#include "RegexStd.h"
+#include "Literal.h"
+#include "Search.h"
+#include "ExportSink.h"
+#include "Substitution.h"
+#include "Benchmark.h"
+#ifdef PCRE2_REGEX
+    #include "Profiler.h"
+#endif
+#include "Stage.h"
+#include "Trace.h"
 #include "model/Match.h"
+#ifdef PCRE2_REGEX
+    #include "RegexPcre.h"
+#endif
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QMdiSubWindow>
+#include <QCoreApplication>
 #include <fstream>
+#include <algorithm>
 #include <fmt/core.h>
 #include <glaze/glaze.hpp>
 
@@ -42,6 +61,10 @@
 char const *const Workspace::NameFilter = QT_TR_NOOP("Regex: (*.%1)");
 char const *const Workspace::FileExt = QT_TR_NOOP("crgx");
 char const *const Workspace::ReadError = QT_TR_NOOP("Something went wrong while reading the file.");
+char const * const Workspace::ExportFilter = QT_TR_NOOP("NDJSON (*.ndjson);;CSV (*.csv);;Columnar (*.crgc)");
+char const * const Workspace::ExportError = QT_TR_NOOP("Can't create the file '%1'.");
+char const * const Workspace::TemporaryFileError = QT_TR_NOOP("Can't create a temporary file for the result.");
+char const * const Workspace::TraceFilter = QT_TR_NOOP("Trace (*.json)");
 char const * const Workspace::NoContentToSave = QT_TR_NOOP("There is no content to save.");
 char const * const Workspace::TryLater = QT_TR_NOOP("If you get something, try again.");
 char const * const Workspace::FileAlreadyExist = QT_TR_NOOP("The file '%1' already exists.");
@@ -66,6 +89,13 @@ Workspace::Workspace(OptionsWidget* const options_widget, QWidget *const parent)
 
     setContentsMargins(Settings::NoMargins);
 
+    // Run of the visible tab goes first on the scheduler.
+    connect(this, &QMdiArea::subWindowActivated, this, [this](QMdiSubWindow const* const active) {
+        for (auto const mdi_subwindow : subWindowList())
+            if (auto const ww = dynamic_cast<WorkingWindow*>(mdi_subwindow->widget()); ww)
+                ww->foreground(mdi_subwindow == active);
+    });
+
     // Restore state from previous session.
     Settings sts;
     if (auto data = sts.read(LastUsedDirectory); data)
@@ -75,6 +105,15 @@ Workspace::Workspace(OptionsWidget* const options_widget, QWidget *const parent)
 
     // I would like to recive these events.
     EventController::instance().append(this, event::RunRequest);
+    EventController::instance().append(this, event::MoreRequest);
+    EventController::instance().append(this, event::SampleRequest);
+    EventController::instance().append(this, event::RunAllRequest);
+    EventController::instance().append(this, event::ExportRequest);
+    EventController::instance().append(this, event::ReplaceRequest);
+    EventController::instance().append(this, event::ReplaceTabRequest);
+    EventController::instance().append(this, event::BenchmarkRequest);
+    EventController::instance().append(this, event::ProfileRequest);
+    EventController::instance().append(this, event::TraceRequest);
     EventController::instance().append(this, event::OpenFile);
     EventController::instance().append(this, event::SaveFile);
     EventController::instance().append(this, event::SaveAsFile);
@@ -99,18 +138,76 @@ void Workspace::customEvent(QEvent *event) {
         case event::RunRequest: {
             // Clear current visible matches content.
             current_mdiwidget()->clear_matches();
-            // Fetch user setting.
-            auto const data = e->data();
-            auto tool = data[0].toInt();
-            auto grammar = data[1].toInt();
-            auto variations = data[2].toString();
-            // Select tool and run.
-            if (tool == tool::Std)
-                if (auto s = glz::read_json<std::vector<type::StdSyntaxOption>>(variations.toStdString()); s)
-                    run_std(type::StdSyntaxOption(grammar), s.value());
+            current_mdiwidget()->metrics_in_matches(options_widget_->metrics());
+            auto const& data = e->data();
+            auto run = prepare(data, current_mdiwidget());
+            // The window keeps the run (groups on demand, next pages).
+            if (current_mdiwidget()->start(std::move(run), isize(data[2].toLongLong()), data[5].toBool()))
+                schedule();
+            e->accept();
+            break;
+        }
+        case event::RunAllRequest: {
+            // Every tab with its own patterns and sources, all at once on the scheduler.
+            auto const& data = e->data();
+            auto const limit = isize(data[2].toLongLong());
+            auto const current = current_mdiwidget();
+            for (auto const mdi_subwindow : subWindowList())
+                if (auto const ww = dynamic_cast<WorkingWindow*>(mdi_subwindow->widget()); ww) {
+                    ww->clear_matches();
+                    ww->metrics_in_matches(options_widget_->metrics());
+                    ww->submit(prepare(data, ww), limit, scheduler_, ww == current);
+                }
+            e->accept();
+            break;
+        }
+        case event::ExportRequest:
+            export_matches(e->data());
+            e->accept();
+            break;
+        case event::BenchmarkRequest:
+            benchmark(e->data());
+            e->accept();
+            break;
+        case event::TraceRequest:
+            trace(e->data()[0].toBool());
+            e->accept();
+            break;
+#ifdef PCRE2_REGEX
+        case event::ProfileRequest:
+            profile(e->data());
+            e->accept();
+            break;
+#endif
+        case event::ReplaceRequest:
+        case event::ReplaceTabRequest:
+            replace(e->data(), int(e->type()) == event::ReplaceTabRequest);
+            e->accept();
+            break;
+        case event::RunSlice: {
+            // One slice for every window with a cooperative run, then the GUI gets time.
+            slicing_ = false;
+            auto again = false;
+            for (auto const mdi_subwindow : subWindowList())
+                if (auto const ww = dynamic_cast<WorkingWindow*>(mdi_subwindow->widget()); ww)
+                    again = ww->slice() or again;
+            if (again)
+                schedule();
             e->accept();
             break;
         }
+        case event::SampleRequest:
+            current_mdiwidget()->clear_matches();
+            // Only the estimate, the user decides if the full run is worth it.
+            current_mdiwidget()->sample(prepare(e->data(), current_mdiwidget()), SampleSize);
+            e->accept();
+            break;
+        case event::MoreRequest:
+            current_mdiwidget()->metrics_in_matches(options_widget_->metrics());
+            if (current_mdiwidget()->more())
+                schedule();
+            e->accept();
+            break;
         case event::OpenFile:
             open();
             e->accept();
@@ -135,49 +232,223 @@ void Workspace::customEvent(QEvent *event) {
     QMdiArea::customEvent(event);
 }
 
-void Workspace::run_std(type::StdSyntaxOption grammar, std::vector<type::StdSyntaxOption> vars) noexcept {
+template<typename Subject, typename... Args>
+std::vector<Subject> Workspace::subjects(WorkingWindow const* const ww, Args... args) const noexcept {
+    trace::Span const span{"prepare", "transform"};
+    std::vector<Subject> buffer;
+    if (document_) {
+        // One subject, positions of matches are mapped back to lines.
+        buffer.emplace_back(ww->source_text(), 0, args..., Scope::Document);
+        return buffer;
+    }
+    auto const lines = ww->source_lines();
+    buffer.reserve(lines.size());
+    for (int i = 0; i < lines.size(); ++i)
+        if (not lines[i].trimmed().isEmpty())
+            buffer.emplace_back(lines[i], i, args..., Scope::Line);
+    return buffer;
+}
+
+std::unique_ptr<Run> Workspace::prepare(qvec<qvar> const& data, WorkingWindow const* const ww,
+                                        std::optional<Granularity> const granularity) noexcept
+{
+    stage::Scope const scope{stage::Prepare};
+    // Fetch user setting.
+    auto const tool = data[0].toInt();
+    granularity_ = granularity.value_or(Granularity(data[1].toInt()));
+    group_ = data[3].toInt();
+    document_ = data[4].toBool();
+    // Select tool and prepare the run.
+    if (tool == tool::Std) {
+        auto grammar = data[6].toInt();
+        auto variations = data[7].toString();
+        if (auto s = glz::read_json<std::vector<type::StdSyntaxOption>>(variations.toStdString()); s)
+            return run_std(ww, type::StdSyntaxOption(grammar), s.value());
+    }
+    if (tool == tool::Qt)
+        return run_qt(ww, data[6].toInt());
+#ifdef PCRE2_REGEX
+    if (tool == tool::Pcre2)
+        return run_pcre2(ww, data[6].toUInt());
+#endif
+    return {};
+}
+
+std::unique_ptr<Run> Workspace::run_std(WorkingWindow const* const ww, type::StdSyntaxOption grammar, std::vector<type::StdSyntaxOption> vars) noexcept {
     auto opt = grammar;
     for (auto it : vars)
         opt |= it;
+    // In the whole document ^ and $ match at lines.
+    if (document_)
+        opt |= std::regex_constants::multiline;
+    // Without captures std::regex does not have to record sub-matches.
+    auto const scan_opt = captures() ? opt : opt | std::regex_constants::nosubs;
 
-    auto const content = current_mdiwidget()->content();
-    auto pattern_lines = content.regex;
-    auto source_lines = content.source;
+    auto const pattern_lines = ww->regex_lines();
     // We need and pattern and source text (both).
-    if (pattern_lines.empty() or source_lines.empty())
-        return;
+    if (pattern_lines.empty() or ww->source_text().trimmed().isEmpty())
+        return {};
+
+    // std::regex works on UTF-8 bytes, every source is converted only once.
+    auto search = std::make_unique<Search<RegexStd, Utf8Subject>>(granularity_, subjects<Utf8Subject>(ww, Utf8Subject::Kind::Text), group_);
+    auto const icase = std::ranges::find(vars, std::regex_constants::icase) not_eq vars.end();
+    try {
+        for (auto const& pattern : pattern_lines) {
+            if (literal(pattern, icase)) {
+                search->add(pattern, Literal{pattern});
+                continue;
+            }
+            // Compiled once, used for all sources.
+            auto const start = Run::Clock::now();
+            auto const text = pattern.toStdString();
+            auto scanner = std::make_unique<RegexStd const>(text, scan_opt);
+            std::unique_ptr<RegexStd const> capturer;
+            if (granularity_ == Granularity::OnDemand)
+                capturer = std::make_unique<RegexStd const>(text, opt);
+            search->add(pattern, std::move(scanner), std::move(capturer), {}, Compiled::since(start));
+        }
+    }
+    catch (std::regex_error const& e) {
+        auto msg = qstr::fromStdString(e.what());
+        QMessageBox::critical((QWidget *) this, Error, msg);
+        return {};
+    }
+    return search;
+}
+
+std::unique_ptr<Run> Workspace::run_qt(WorkingWindow const* const ww, int const options) noexcept {
+    auto const pattern_lines = ww->regex_lines();
+    // We need and pattern and source text (both).
+    if (pattern_lines.empty() or ww->source_text().trimmed().isEmpty())
+        return {};
+
+    auto search = std::make_unique<Search<RegexQt, Utf16Subject>>(granularity_, subjects<Utf16Subject>(ww), group_);
+    QRegularExpression::PatternOptions opts(options);
+    // In the whole document ^ and $ match at lines.
+    if (document_)
+        opts |= QRegularExpression::MultilineOption;
+    auto const scan_opts = captures() ? opts : opts | QRegularExpression::DontCaptureOption;
+    auto const icase = opts.testFlag(QRegularExpression::CaseInsensitiveOption);
 
     for (auto const& pattern : pattern_lines) {
-        for (auto const& source : source_lines) {
-            try {
-                std::regex rgx(pattern, opt);
-                auto match_begin_it = std::sregex_iterator(source.begin(), source.end(), rgx);
-                auto match_end_it = std::sregex_iterator();
-                std::vector<Match> buffer;
-                for (auto it = match_begin_it; it != match_end_it; ++it) {
-                    std::smatch match = *it;
-                    EventController::instance().send_event(event::AppendLine, "--------------------------");
-                    for (uint i = 0; i < match.size(); ++i) {
-                        auto const pos = int(match.position(i));
-                        auto const length = int(match.length(i));
-                        auto const str = match.str(i);
-                        // TODO: trzeba ujednolicić
-                        auto const text{fmt::format("${}: '{}' ({}, {})", i, str, pos, length)};
-                        EventController::instance().send_event(event::AppendLine, qstr::fromStdString(text));
-                        buffer.push_back(Match{.nr = int(i), .pos = pos, .length = length, .str = str});
-                    }
-                }
-                auto matches_json = glz::write_json(buffer);
-                EventController::instance().send_event(event::Match, qstr::fromStdString(matches_json));
-            }
-            catch (std::regex_error const& e) {
-                auto msg = qstr::fromStdString(e.what());
-                QMessageBox::critical((QWidget *) this, Error, msg);
-                return;
-            }
-            EventController::instance().send_event(event::AppendLine, "--- END ---");
+        if (literal(pattern, icase)) {
+            search->add(pattern, Literal{pattern});
+            continue;
+        }
+        // Compiled and optimized once, reused in next runs.
+        auto const start = Run::Clock::now();
+        bool cached{};
+        auto scanner = std::make_unique<RegexQt const>(RegexQt::cached(pattern, scan_opts, &cached));
+        if (not scanner->valid()) {
+            QMessageBox::critical((QWidget *) this, Error, scanner->error());
+            return {};
+        }
+        std::unique_ptr<RegexQt const> capturer;
+        if (granularity_ == Granularity::OnDemand)
+            capturer = std::make_unique<RegexQt const>(RegexQt::cached(pattern, opts));
+        search->add(pattern, std::move(scanner), std::move(capturer), {}, Compiled::since(start, cached));
+    }
+    return search;
+}
+
+#ifdef PCRE2_REGEX
+std::unique_ptr<Run> Workspace::run_pcre2(WorkingWindow const* const ww, u32 options) noexcept {
+    // In the whole document ^ and $ match at lines.
+    if (document_)
+        options |= PCRE2_MULTILINE;
+    // Without captures PCRE2 needs ovector for the whole match only.
+    auto const scan_options = captures() ? options : options | PCRE2_NO_AUTO_CAPTURE;
+    // Without UTF the subject is a sequence of bytes.
+    if (not (options & PCRE2_UTF))
+        return run_pcre2_bytes(ww, options, scan_options);
+
+    auto const pattern_lines = ww->regex_lines();
+    // We need and pattern and source text (both).
+    if (pattern_lines.empty() or ww->source_text().trimmed().isEmpty())
+        return {};
+
+    auto search = std::make_unique<Search<RegexPcre16, Utf16Subject>>(granularity_, subjects<Utf16Subject>(ww), group_);
+    auto const icase = (options & PCRE2_CASELESS) not_eq 0;
+    for (auto const& pattern : pattern_lines) {
+        if (literal(pattern, icase)) {
+            search->add(pattern, Literal{pattern});
+            continue;
+        }
+
+        auto const start = Run::Clock::now();
+        auto const data = reinterpret_cast<char16_t const*>(pattern.utf16());
+        auto const n = std::size_t(pattern.size());
+        // QString keeps text in UTF-16, we match directly on its data (no transcoding),
+        // so offsets are QString positions and Highlighter can use them as they are.
+        auto scanner = std::make_unique<RegexPcre16>(data, n, scan_options);
+        if (not scanner->valid()) {
+            QMessageBox::critical((QWidget *) this, Error, qstr::fromStdString(scanner->error()));
+            return {};
+        }
+        // Scanners run for every source - machine code pays off (the interpreter is used if JIT is not available).
+        scanner->jit();
+        std::unique_ptr<RegexPcre16 const> capturer;
+        if (granularity_ == Granularity::OnDemand)
+            capturer = std::make_unique<RegexPcre16 const>(data, n, options);
+        // UTF handling is not needed if the pattern and the source are pure ASCII.
+        std::unique_ptr<RegexPcre16> ascii;
+        if (simd::is_ascii(pattern)) {
+            ascii = std::make_unique<RegexPcre16>(data, n, scan_options & ~(PCRE2_UTF | PCRE2_UCP));
+            ascii->jit();
         }
+        search->add(pattern, std::move(scanner), std::move(capturer), std::move(ascii), Compiled::since(start));
     }
+    return search;
+}
+
+std::unique_ptr<Run> Workspace::run_pcre2_bytes(WorkingWindow const* const ww, u32 const options, u32 const scan_options) noexcept {
+    auto const pattern_lines = ww->regex_lines();
+    // We need and pattern and source text (both).
+    if (pattern_lines.empty() or ww->source_text().trimmed().isEmpty())
+        return {};
+
+    auto search = std::make_unique<Search<RegexPcre, Utf8Subject>>(
+            granularity_, subjects<Utf8Subject>(ww, Utf8Subject::Kind::Bytes), group_);
+    for (auto const& pattern : pattern_lines) {
+        if (literal(pattern, (options & PCRE2_CASELESS) not_eq 0)) {
+            search->add(pattern, Literal{pattern});
+            continue;
+        }
+        auto const start = Run::Clock::now();
+        auto const bytes = pattern.toUtf8();
+        auto const n = std::size_t(bytes.size());
+        auto scanner = std::make_unique<RegexPcre>(bytes.constData(), n, scan_options);
+        if (not scanner->valid()) {
+            QMessageBox::critical((QWidget *) this, Error, qstr::fromStdString(scanner->error()));
+            return {};
+        }
+        scanner->jit();
+        std::unique_ptr<RegexPcre const> capturer;
+        if (granularity_ == Granularity::OnDemand)
+            capturer = std::make_unique<RegexPcre const>(bytes.constData(), n, options);
+        search->add(pattern, std::move(scanner), std::move(capturer), {}, Compiled::since(start));
+    }
+    return search;
+}
+#endif
+
+void Workspace::schedule() noexcept {
+    if (slicing_)
+        return;
+    slicing_ = true;
+    // Low priority - user input and painting go first.
+    QCoreApplication::postEvent(this, new Event(event::RunSlice), Qt::LowEventPriority);
+}
+
+bool Workspace::captures() const noexcept {
+    return granularity_ == Granularity::Offsets
+        or granularity_ == Granularity::Full
+        or granularity_ == Granularity::GroupBy;
+}
+
+bool Workspace::literal(qstr const& pattern, bool const icase) const noexcept {
+    // Only when nothing but the whole match is needed (a literal has no groups).
+    return not captures() and not icase and Literal::is_literal(pattern);
 }
 
 void Workspace::save() noexcept {
@@ -201,6 +472,234 @@ void Workspace::save() noexcept {
     save(QFileInfo(mdi_subwidget->path()), content);
 }
 
+void Workspace::export_matches(qvec<qvar> const& data) noexcept {
+    auto const ww = current_mdiwidget();
+
+    QFileDialog dialog(qApp->activeWindow());
+    dialog.setOption(QFileDialog::DontUseNativeDialog);
+    dialog.setFileMode(QFileDialog::AnyFile);
+    dialog.setViewMode(QFileDialog::List);
+    dialog.setAcceptMode(QFileDialog::AcceptSave);
+    dialog.setNameFilter(tr(ExportFilter));
+    dialog.setDirectory(last_used_dir_);
+    if (not dialog.exec())
+        return;
+
+    // The selected filter decides the format if the name has no extension.
+    auto path = dialog.selectedFiles().first();
+    if (QFileInfo(path).suffix().isEmpty()) {
+        static constexpr char const* suffixes[]{".ndjson", ".csv", ".crgc"};
+        auto const index = tr(ExportFilter).split(";;").indexOf(dialog.selectedNameFilter());
+        path += suffixes[std::clamp(int(index), 0, 2)];
+    }
+    auto const file = path.toStdString();
+    auto sink = ExportSink::create(file, ExportSink::format_for(file));
+    if (not sink) {
+        QMessageBox::critical((QWidget *) this, Error, tr(ExportError).arg(path));
+        return;
+    }
+    // Every match with all its groups and their text, whatever granularity is selected
+    // (Count and GroupBy send no matches, Any only the first one, Offsets no text).
+    ww->export_to(prepare(data, ww, Granularity::Full), std::move(sink), scheduler_);
+}
+
+void Workspace::benchmark(qvec<qvar> const& data) noexcept {
+    auto const ww = current_mdiwidget();
+    ww->clear_matches();
+    document_ = data[4].toBool();
+
+    auto workload = std::make_shared<Benchmark::Workload>();
+    workload->patterns = ww->regex_lines();
+    // We need and pattern and source text (both).
+    if (workload->patterns.empty() or ww->source_text().trimmed().isEmpty())
+        return;
+    // Sources are converted once, conversions are not measured.
+    workload->utf8 = subjects<Utf8Subject>(ww, Utf8Subject::Kind::Text);
+    workload->utf16 = subjects<Utf16Subject>(ww);
+
+    // Every engine with its options from the panel (the selected tool does not matter).
+    auto [grammar, variations] = options_widget_->options_std();
+    for (auto const it : variations)
+        grammar |= it;
+    QRegularExpression::PatternOptions qt_options(options_widget_->options_qt());
+    if (document_) {
+        // In the whole document ^ and $ match at lines.
+        grammar |= std::regex_constants::multiline;
+        qt_options |= QRegularExpression::MultilineOption;
+    }
+    std::vector<Benchmark::Engine> engines{
+        Benchmark::std_engine(workload, grammar),
+    };
+#ifdef PCRE2_REGEX
+    auto pcre2_options = options_widget_->options_pcre2();
+    if (document_)
+        pcre2_options |= PCRE2_MULTILINE;
+    engines.push_back(Benchmark::pcre2_engine(workload, pcre2_options, Benchmark::Mode::Interpreter));
+    engines.push_back(Benchmark::pcre2_engine(workload, pcre2_options, Benchmark::Mode::Jit));
+    engines.push_back(Benchmark::pcre2_engine(workload, pcre2_options, Benchmark::Mode::Dfa));
+#endif
+    engines.push_back(Benchmark::qt_engine(workload, qt_options.toInt()));
+
+    bench::Plan const plan{.warmup = 1, .reps = options_widget_->runs()};
+    ww->submit(std::make_unique<Benchmark>(std::move(engines), plan, std::move(workload)), 0, scheduler_, true);
+}
+
+void Workspace::trace(bool const on) noexcept {
+    if (on) {
+        trace::start();
+        return;
+    }
+    trace::stop();
+
+    QFileDialog dialog(qApp->activeWindow());
+    dialog.setOption(QFileDialog::DontUseNativeDialog);
+    dialog.setFileMode(QFileDialog::AnyFile);
+    dialog.setViewMode(QFileDialog::List);
+    dialog.setAcceptMode(QFileDialog::AcceptSave);
+    dialog.setNameFilter(tr(TraceFilter));
+    dialog.setDirectory(last_used_dir_);
+    if (not dialog.exec())
+        return;
+
+    auto path = dialog.selectedFiles().first();
+    if (QFileInfo(path).suffix().isEmpty())
+        path += ".json";
+    if (not trace::write(path.toStdString()))
+        QMessageBox::critical((QWidget *) this, Error, tr(ExportError).arg(path));
+}
+
+#ifdef PCRE2_REGEX
+void Workspace::profile(qvec<qvar> const& data) noexcept {
+    auto const ww = current_mdiwidget();
+    ww->clear_matches();
+    document_ = data[4].toBool();
+
+    auto patterns = ww->regex_lines();
+    // We need and pattern and source text (both).
+    if (patterns.empty() or ww->source_text().trimmed().isEmpty())
+        return;
+    // PCRE2 whatever tool is selected - on UTF-16 positions of items are positions in the editor.
+    auto options = options_widget_->options_pcre2();
+    if (document_)
+        options |= PCRE2_MULTILINE;
+    auto profiler = std::make_unique<Profiler>(subjects<Utf16Subject>(ww), std::move(patterns), options);
+    ww->submit(std::move(profiler), 0, scheduler_, true);
+}
+#endif
+
+void Workspace::replace(qvec<qvar> const& data, bool const to_tab) noexcept {
+    auto const ww = current_mdiwidget();
+
+    if (to_tab) {
+        // The result goes to a temporary file, the new tab loads it when the run is done.
+        auto output = std::make_unique<BufferedFile>();
+        if (not output->valid()) {
+            QMessageBox::critical((QWidget *) this, Error, tr(TemporaryFileError));
+            return;
+        }
+        auto run = substitution(data, ww, std::move(output));
+        if (not run)
+            return;
+        // The new tab has the same patterns as its source, the result becomes its source.
+        Content content;
+        for (auto const& pattern : ww->regex_lines())
+            content.regex.push_back(pattern.toStdString());
+        auto const tab = new WorkingWindow;
+        tab->set_content(content);
+        addSubWindow(tab)->show();
+        tab->substitute(std::move(run), scheduler_);
+        return;
+    }
+
+    QFileDialog dialog(qApp->activeWindow());
+    dialog.setOption(QFileDialog::DontUseNativeDialog);
+    dialog.setFileMode(QFileDialog::AnyFile);
+    dialog.setViewMode(QFileDialog::List);
+    dialog.setAcceptMode(QFileDialog::AcceptSave);
+    dialog.setDirectory(last_used_dir_);
+    if (not dialog.exec())
+        return;
+
+    auto const path = dialog.selectedFiles().first();
+    auto output = std::make_unique<BufferedFile>(path.toStdString());
+    if (not output->valid()) {
+        QMessageBox::critical((QWidget *) this, Error, tr(ExportError).arg(path));
+        return;
+    }
+    if (auto run = substitution(data, ww, std::move(output)); run) {
+        ww->clear_matches();
+        ww->submit(std::move(run), 0, scheduler_, true);
+    }
+}
+
+std::unique_ptr<Substitution> Workspace::substitution(qvec<qvar> const& data, WorkingWindow const* const ww,
+                                                      std::unique_ptr<BufferedFile> output) noexcept
+{
+    auto const pattern_lines = ww->regex_lines();
+    if (pattern_lines.empty())
+        return {};
+    auto const tool = data[0].toInt();
+    auto const replacement = options_widget_->replacement();
+    // Lines are read from the text of the editor (shared, not copied) and rewritten one by one.
+    auto run = std::make_unique<Substitution>(ww->source_text(), std::move(output), options_widget_->preview());
+
+    if (tool == tool::Std) {
+        auto opt = type::StdSyntaxOption(data[6].toInt());
+        if (auto s = glz::read_json<std::vector<type::StdSyntaxOption>>(data[7].toString().toStdString()); s)
+            for (auto const it : s.value())
+                opt |= it;
+        auto const format = replacement.toStdString();
+        try {
+            for (auto const& pattern : pattern_lines) {
+                auto const rgx = std::make_shared<RegexStd const>(pattern.toStdString(), opt);
+                run->add(pattern, [rgx, format](std::string_view const line, std::string& out) {
+                    return rgx->replace(line.data(), line.size(), format, out);
+                });
+            }
+        }
+        catch (std::regex_error const& e) {
+            QMessageBox::critical((QWidget *) this, Error, qstr::fromStdString(e.what()));
+            return {};
+        }
+        return run;
+    }
+    if (tool == tool::Qt) {
+        auto const opts = QRegularExpression::PatternOptions(data[6].toInt());
+        for (auto const& pattern : pattern_lines) {
+            auto const rgx = std::make_shared<RegexQt const>(RegexQt::cached(pattern, opts));
+            if (not rgx->valid()) {
+                QMessageBox::critical((QWidget *) this, Error, rgx->error());
+                return {};
+            }
+            // Lines stay in QString for all patterns.
+            run->add(pattern, Substitution::QtRewrite{[rgx, replacement](qstr const& line, qstr& out) {
+                return rgx->replace(line, replacement, out);
+            }});
+        }
+        return run;
+    }
+#ifdef PCRE2_REGEX
+    if (tool == tool::Pcre2) {
+        // Lines are UTF-8, the 8-bit library works on them directly.
+        auto const options = data[6].toUInt();
+        auto const format = replacement.toStdString();
+        for (auto const& pattern : pattern_lines) {
+            auto const bytes = pattern.toUtf8();
+            auto const rgx = std::make_shared<RegexPcre const>(bytes.constData(), std::size_t(bytes.size()), options);
+            if (not rgx->valid()) {
+                QMessageBox::critical((QWidget *) this, Error, qstr::fromStdString(rgx->error()));
+                return {};
+            }
+            run->add(pattern, [rgx, format](std::string_view const line, std::string& out) {
+                return rgx->replace(line.data(), line.size(), format.data(), format.size(), out);
+            });
+        }
+        return run;
+    }
+#endif
+    return {};
+}
+
 void Workspace::save_as() noexcept {
     auto const mdi_subwidget = current_mdiwidget();
     auto const content = mdi_subwidget->content();
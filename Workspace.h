@@ -27,8 +27,11 @@
 -------------------------------------------------------------------*/
 #include "Types.h"
 #include "Content.h"
+#include "Scheduler.h"
 #include <QMdiArea>
 #include <QFileInfo>
+#include <memory>
+#include <optional>
 #include <vector>
 
 /*------- forward declarations:
@@ -36,6 +39,9 @@
 class QEvent;
 class WorkingWindow;
 class OptionsWidget;
+class Run;
+class Substitution;
+class BufferedFile;
 
 /*------- class:
 -------------------------------------------------------------------*/
@@ -49,10 +55,53 @@ private:
     /// \param event - event to handle (firstly cast to user Event).
     void customEvent(QEvent* event) override;
 
-    /// Execute regex process for std.
+    /// Prepare regex run for the tool and options from the request.
+    /// \param data - data of the request (RunRequest, RunAllRequest or SampleRequest)
+    ///   (tool, granularity, limit, group, document, sliced, options of the tool...),
+    /// \param ww - the window with patterns and sources,
+    /// \param granularity - overrides the granularity of the request (e.g. an export needs all groups).
+    std::unique_ptr<Run> prepare(qvec<qvar> const& data, WorkingWindow const* ww,
+                                 std::optional<Granularity> granularity = {}) noexcept;
+
+    /// Prepare regex run for std.
+    /// \param ww - the window with patterns and sources,
     /// \param grammar - information about used grammar,
     /// \param variations - other user requirements
-    void run_std(type::StdSyntaxOption grammar, std::vector<type::StdSyntaxOption> variations) noexcept;
+    /// \return the run or nullptr if there is nothing to do (or the pattern is invalid).
+    std::unique_ptr<Run> run_std(WorkingWindow const* ww, type::StdSyntaxOption grammar, std::vector<type::StdSyntaxOption> variations) noexcept;
+
+    /// Prepare regex run for Qt (QRegularExpression directly on QString data).
+    /// \param ww - the window with patterns and sources,
+    /// \param options - QRegularExpression pattern options.
+    std::unique_ptr<Run> run_qt(WorkingWindow const* ww, int options) noexcept;
+
+#ifdef PCRE2_REGEX
+    /// Prepare regex run for PCRE2 (16-bit, directly on QString data).
+    /// \param ww - the window with patterns and sources,
+    /// \param options - PCRE2 compile options.
+    std::unique_ptr<Run> run_pcre2(WorkingWindow const* ww, u32 options) noexcept;
+
+    /// Prepare regex run for PCRE2 in byte mode (8-bit, no UTF, no UCP). \n
+    /// Every byte (NUL too) is a character.
+    /// \param ww - the window with patterns and sources,
+    /// \param options - PCRE2 compile options (with captures),
+    /// \param scan_options - PCRE2 compile options used for the scan.
+    std::unique_ptr<Run> run_pcre2_bytes(WorkingWindow const* ww, u32 options, u32 scan_options) noexcept;
+#endif
+
+    /// Sources in the form the engine works on - not empty lines or the whole document.
+    template<typename Subject, typename... Args>
+    std::vector<Subject> subjects(WorkingWindow const* ww, Args... args) const noexcept;
+
+    /// Post the request of the next time slice to itself (if not posted yet). \n
+    /// Cooperative runs are resumed from the event loop - no threads needed.
+    void schedule() noexcept;
+
+    /// Checks if the selected granularity needs capture groups during the scan.
+    [[nodiscard]] bool captures() const noexcept;
+
+    /// Checks if the pattern can be searched as plain text (no engine needed).
+    [[nodiscard]] bool literal(qstr const& pattern, bool icase) const noexcept;
 
     /// Open and read file from disk. \n
     /// Content for current mdi-subwindow.
@@ -71,12 +120,59 @@ private:
     /// \param fi - information about the file (path)
     /// \param content - content to save.
     void save(QFileInfo const& fi, const Content& content) noexcept;
+
+    /// Export matches of the run of current mdi-subwindow to the file chosen by the user. \n
+    /// The format follows the chosen filter (NDJSON, CSV or columnar).
+    /// \param data - payload of the run request.
+    void export_matches(qvec<qvar> const& data) noexcept;
+
+    /// Benchmark of the patterns with the sources of current mdi-subwindow on every engine
+    /// (options of each engine from the options panel), on the scheduler. \n
+    /// The report goes to the matches-view.
+    /// \param data - payload of the run request.
+    void benchmark(qvec<qvar> const& data) noexcept;
+
+    /// Start recording of the trace or stop it and write the trace to the file chosen by the user
+    /// (Chrome trace-event JSON for Perfetto or chrome://tracing).
+    /// \param on - start (true) or stop (false).
+    void trace(bool on) noexcept;
+
+#ifdef PCRE2_REGEX
+    /// Profile of backtracking of the patterns of current mdi-subwindow with its sources
+    /// (PCRE2 with options from the options panel), on the scheduler. \n
+    /// Hot spots go to the matches-view, the heatmap over the regex-editor.
+    /// \param data - payload of the run request.
+    void profile(qvec<qvar> const& data) noexcept;
+#endif
+
+    /// Search-and-replace in the source of current mdi-subwindow. \n
+    /// The diff preview goes to the matches-view, the result to the file chosen by the user
+    /// (streamed on the scheduler) or to a new tab.
+    /// \param data - payload of the run request,
+    /// \param to_tab - the result goes to a new tab.
+    void replace(qvec<qvar> const& data, bool to_tab) noexcept;
+
+    /// Substitution with patterns of the window compiled for the tool from the request.
+    /// \param output - the file for the result (nullptr - the result is kept in memory),
+    /// \return the substitution or nullptr if there is nothing to do (or a pattern is invalid).
+    std::unique_ptr<Substitution> substitution(qvec<qvar> const& data, WorkingWindow const* ww,
+                                               std::unique_ptr<BufferedFile> output) noexcept;
     [[nodiscard]] WorkingWindow* current_mdiwidget() const noexcept;
 
     OptionsWidget* const options_widget_;
+    Scheduler scheduler_{};
+    Granularity granularity_{Granularity::Full};
+    int group_{};
+    bool document_{};
+    bool slicing_{};
     qstr last_used_dir_{};
     qstr last_used_file_name_{};
+    static constexpr isize SampleSize = 1000;
     static char const * const NameFilter;
+    static char const * const ExportFilter;
+    static char const * const ExportError;
+    static char const * const TemporaryFileError;
+    static char const * const TraceFilter;
     static char const * const FileExt;
     static char const * const ReadError;
     static char const * const NoContentToSave;
@@ -0,0 +1,416 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Bench.h"
+#include "model/Stats.h"
+#include "RegexStd.h"
+#include "RegexQt.h"
+#ifdef PCRE2_REGEX
+    #include "RegexPcre.h"
+#endif
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <glaze/glaze.hpp>
+#include <fmt/core.h>
+
+namespace {
+    char const* const Usage =
+        "usage: ccregex_bench [options]\n"
+        "  --engine E,...     engines (or their prefixes: std, pcre2, qt) to measure (default: all)\n"
+        "  --pattern P,...    pattern classes: literal, class, alternation, backtracking, captures\n"
+        "  --sizes S,...      input sizes with K, M or G suffix (default: 1K,64K,1M,16M, up to 1G)\n"
+        "  --warmup N         not measured runs before repetitions (default: 1)\n"
+        "  --reps N           measured repetitions (default: 10)\n"
+        "  --budget MS        repetitions of one case are cut down to fit the time (default: 5000)\n"
+        "  --json             print results as JSON (default: a table)\n"
+        "Times are in milliseconds: min, median and p99 of repetitions. One repetition finds all matches\n"
+        "in all lines of the input (as the matches-view does), compilation is measured separately.\n";
+
+    /// One class of patterns, written for every grammar (empty - not expressible in the grammar).
+    struct Pattern {
+        std::string name;
+        std::string ecma;   // ECMAScript, PCRE2 and Qt
+        std::string ere;    // POSIX extended, awk, egrep
+        std::string bre;    // POSIX basic, grep
+    };
+
+    std::vector<Pattern> const Patterns{
+            {"literal", "needle", "needle", "needle"},
+            {"class", "[a-z]{7,}", "[a-z]{7,}", "[a-z]\\{7,\\}"},
+            {"alternation", "apple|banana|cherry|durian|elderberry|fig|grape",
+                            "apple|banana|cherry|durian|elderberry|fig|grape", ""},
+            // The input has no '=' or ';', every line is backtracked through (quadratic in its length).
+            {"backtracking", "^(.*)(.*)[=;]", "^(.*)(.*)[=;]", "^\\(.*\\)\\(.*\\)[=;]"},
+            {"captures", "([a-z]+)@([a-z]+)\\.(com|org|net)", "([a-z]+)@([a-z]+)\\.(com|org|net)", ""},
+    };
+
+    /// Generated text (the same for every run), lines are ready for every engine.
+    struct Corpus {
+        std::string text{};
+        std::vector<std::string_view> lines{};
+        qstrings utf16{};
+
+        Corpus(Corpus const&) = delete;
+        Corpus& operator=(Corpus const&) = delete;
+        Corpus(isize const size, bool const with_utf16) :
+            text{bench::text(size)}
+        {
+            std::string_view rest = text;
+            while (not rest.empty()) {
+                auto const pos = rest.find('\n');
+                lines.push_back(rest.substr(0, pos));
+                if (pos == std::string_view::npos)
+                    break;
+                rest.remove_prefix(pos + 1);
+            }
+            if (with_utf16) {
+                utf16.reserve(isize(lines.size()));
+                for (auto const line : lines)
+                    utf16.push_back(qstr::fromUtf8(line.data(), isize(line.size())));
+            }
+        }
+    };
+
+    /// Finds all matches in the corpus, returns their number.
+    using Scan = std::function<isize(Corpus const&)>;
+
+    /// Engine with its settings, compiles the pattern for scans.
+    /// Compilation throws if the pattern is not supported.
+    struct Engine {
+        std::string name;
+        std::function<Scan(Pattern const&)> compile;
+        bool utf16{};
+    };
+
+    template<typename Regex>
+    isize count(Regex const& re, Corpus const& corpus) {
+        isize n{};
+        for (auto const line : corpus.lines)
+            for ([[maybe_unused]] auto const& hit : re.matches(line.data(), line.size()))
+                ++n;
+        return n;
+    }
+
+    Engine std_engine(std::string name, type::StdSyntaxOption const grammar, type::StdSyntaxOption const flags = {}) {
+        auto compile = [grammar, flags](Pattern const& pattern) -> Scan {
+            using namespace std::regex_constants;
+            auto const& text = grammar == ECMAScript ? pattern.ecma
+                             : (grammar == basic or grammar == grep) ? pattern.bre
+                             : pattern.ere;
+            if (text.empty())
+                throw std::invalid_argument("not expressible in the grammar");
+            auto const re = std::make_shared<RegexStd const>(text, grammar | flags);
+            return [re](Corpus const& corpus) { return count(*re, corpus); };
+        };
+        return {std::move(name), std::move(compile)};
+    }
+
+#ifdef PCRE2_REGEX
+    enum class Mode { Interpreter, Jit, Dfa };
+
+    Engine pcre2_engine(std::string name, Mode const mode) {
+        auto compile = [mode](Pattern const& pattern) -> Scan {
+            auto const re = std::make_shared<RegexPcre>(pattern.ecma.data(), pattern.ecma.size(), PCRE2_UTF);
+            if (not re->valid())
+                throw std::invalid_argument(re->error());
+            if (mode == Mode::Jit and not re->jit())
+                throw std::runtime_error("JIT is not available");
+            if (mode not_eq Mode::Dfa)
+                return [re](Corpus const& corpus) { return count(*re, corpus); };
+
+            return [re](Corpus const& corpus) {
+                isize n{};
+                std::string error;
+                for (auto const line : corpus.lines) {
+                    for ([[maybe_unused]] auto const& hit : re->dfa_matches(line.data(), line.size(), &error))
+                        ++n;
+                    if (not error.empty())
+                        throw std::runtime_error(error);
+                }
+                return n;
+            };
+        };
+        return {std::move(name), std::move(compile)};
+    }
+#endif
+
+    Engine qt_engine() {
+        auto compile = [](Pattern const& pattern) -> Scan {
+            auto const re = std::make_shared<RegexQt const>(qstr::fromStdString(pattern.ecma), QRegularExpression::NoPatternOption);
+            if (not re->valid())
+                throw std::invalid_argument(re->error().toStdString());
+            return [re](Corpus const& corpus) {
+                isize n{};
+                for (auto const& line : corpus.utf16)
+                    for ([[maybe_unused]] auto const& hit : re->matches(line))
+                        ++n;
+                return n;
+            };
+        };
+        return {"qt", std::move(compile), true};
+    }
+
+    /// All grammars, ECMAScript with every flag the options panel offers, all PCRE2 matchers and Qt.
+    std::vector<Engine> engines() {
+        using namespace std::regex_constants;
+        std::vector<Engine> buffer{
+                std_engine("std/ecmascript", ECMAScript),
+                std_engine("std/basic", basic),
+                std_engine("std/extended", extended),
+                std_engine("std/awk", awk),
+                std_engine("std/grep", grep),
+                std_engine("std/egrep", egrep),
+                std_engine("std/ecmascript+icase", ECMAScript, icase),
+                std_engine("std/ecmascript+nosubs", ECMAScript, nosubs),
+                std_engine("std/ecmascript+optimize", ECMAScript, optimize),
+                std_engine("std/ecmascript+collate", ECMAScript, collate),
+                std_engine("std/ecmascript+multiline", ECMAScript, multiline),
+        };
+#ifdef PCRE2_REGEX
+        buffer.push_back(pcre2_engine("pcre2/interpreter", Mode::Interpreter));
+        buffer.push_back(pcre2_engine("pcre2/jit", Mode::Jit));
+        buffer.push_back(pcre2_engine("pcre2/dfa", Mode::Dfa));
+#endif
+        buffer.push_back(qt_engine());
+        return buffer;
+    }
+
+    /// One line of the report.
+    struct Row {
+        std::string pattern{};
+        std::string engine{};
+        std::string phase{};    // compile or match
+        isize bytes{};
+        double min_ms{};
+        double median_ms{};
+        double p99_ms{};
+        double mean_ms{};
+        isize runs{};
+        double mb_per_s{};      // of the median
+        isize matches{};
+        std::optional<Hardware> hardware{};     // of one repetition (null - counters not available)
+        std::string error{};
+    };
+
+    strings split(std::string_view text, char const separator) {
+        strings buffer;
+        for (auto pos = text.find(separator); ; pos = text.find(separator)) {
+            if (auto const item = text.substr(0, pos); not item.empty())
+                buffer.emplace_back(item);
+            if (pos == std::string_view::npos)
+                return buffer;
+            text.remove_prefix(pos + 1);
+        }
+    }
+
+    /// Size like 64K, 16M or 1G (binary units).
+    isize size_of(std::string const& text) {
+        char* end{};
+        auto size = isize(std::strtoll(text.c_str(), &end, 10));
+        switch (*end) {
+            case 'G': case 'g': size <<= 10; [[fallthrough]];
+            case 'M': case 'm': size <<= 10; [[fallthrough]];
+            case 'K': case 'k': size <<= 10; break;
+            default: {}
+        }
+        return size;
+    }
+
+    std::string size_name(isize const size) {
+        if (size >= (1 << 30) and size % (1 << 30) == 0) return fmt::format("{}G", size >> 30);
+        if (size >= (1 << 20) and size % (1 << 20) == 0) return fmt::format("{}M", size >> 20);
+        if (size >= (1 << 10) and size % (1 << 10) == 0) return fmt::format("{}K", size >> 10);
+        return fmt::format("{}", size);
+    }
+
+    /// Checks if the name was selected (selection items are names or their prefixes).
+    bool selected(strings const& selection, std::string const& name) noexcept {
+        return selection.empty() or std::ranges::any_of(selection, [&](auto const& item) {
+            return name.starts_with(item);
+        });
+    }
+}
+
+/*------- template struct for glz:
+-------------------------------------------------------------------*/
+template<>
+struct glz::meta<Row> {
+    using T = Row;
+    static constexpr auto value = object(
+            "pattern", &T::pattern,
+            "engine", &T::engine,
+            "phase", &T::phase,
+            "bytes", &T::bytes,
+            "min_ms", &T::min_ms,
+            "median_ms", &T::median_ms,
+            "p99_ms", &T::p99_ms,
+            "mean_ms", &T::mean_ms,
+            "runs", &T::runs,
+            "mb_per_s", &T::mb_per_s,
+            "matches", &T::matches,
+            "hardware", &T::hardware,
+            "error", &T::error
+    );
+};
+
+int main(int argc, char* argv[]) {
+    strings engine_names, pattern_names;
+    strings sizes{"1K", "64K", "1M", "16M"};
+    bench::Plan plan{.warmup = 1, .reps = 10, .budget = 5000.};
+    bool json{};
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view const arg = argv[i];
+        auto const value = [&]() -> std::string_view {
+            return i + 1 < argc ? argv[++i] : "";
+        };
+        if (arg == "--engine") engine_names = split(value(), ',');
+        else if (arg == "--pattern") pattern_names = split(value(), ',');
+        else if (arg == "--sizes") sizes = split(value(), ',');
+        else if (arg == "--warmup") plan.warmup = std::max(0, std::atoi(std::string(value()).c_str()));
+        else if (arg == "--reps") plan.reps = std::max(1, std::atoi(std::string(value()).c_str()));
+        else if (arg == "--budget") plan.budget = std::max(0., std::atof(std::string(value()).c_str()));
+        else if (arg == "--json") json = true;
+        else if (arg == "--help" or arg == "-h") {
+            fmt::print("{}", Usage);
+            return 0;
+        }
+        else {
+            fmt::print(stderr, "unknown option '{}'\n{}", arg, Usage);
+            return 2;
+        }
+    }
+
+    std::vector<Engine> chosen;
+    for (auto& engine : engines())
+        if (selected(engine_names, engine.name))
+            chosen.push_back(std::move(engine));
+    std::vector<Pattern> patterns;
+    for (auto const& pattern : Patterns)
+        if (selected(pattern_names, pattern.name))
+            patterns.push_back(pattern);
+    std::vector<isize> bytes;
+    for (auto const& size : sizes)
+        if (auto const n = size_of(size); n > 0 and n <= (isize(1) << 30))
+            bytes.push_back(n);
+    if (chosen.empty() or patterns.empty() or bytes.empty()) {
+        fmt::print(stderr, "nothing to measure\n{}", Usage);
+        return 2;
+    }
+    auto const with_utf16 = std::ranges::any_of(chosen, [](auto const& engine) { return engine.utf16; });
+
+    // Without counters (no perf events) only times are reported.
+    auto const counted = perf::Counters::local().available();
+    std::vector<Row> rows;
+    auto const print = [json](Row const& row) {
+        if (json) return;
+        auto const size = row.phase == "compile" ? row.phase : size_name(row.bytes);
+        if (not row.error.empty()) {
+            fmt::print("{:<13} {:<26} {:>8}   {}\n", row.pattern, row.engine, size, row.error);
+            return;
+        }
+        if (row.phase == "compile") {
+            fmt::print("{:<13} {:<26} {:>8} {:>11.3f} {:>11.3f} {:>11.3f}\n",
+                       row.pattern, row.engine, size, row.min_ms, row.median_ms, row.p99_ms);
+            return;
+        }
+        fmt::print("{:<13} {:<26} {:>8} {:>11.3f} {:>11.3f} {:>11.3f} {:>10.1f} {:>10}",
+                   row.pattern, row.engine, size, row.min_ms, row.median_ms, row.p99_ms, row.mb_per_s, row.matches);
+        if (auto const& hw = row.hardware; hw)
+            fmt::print(" {:>6.2f} {:>10.4f} {:>10.4f} {:>10.4f}", hw->ipc,
+                       row.bytes ? double(hw->branch_misses) / double(row.bytes) : 0.0,
+                       hw->l1_misses_per_byte, hw->llc_misses_per_byte);
+        fmt::print("\n");
+    };
+    if (not json) {
+        fmt::print("{:<13} {:<26} {:>8} {:>11} {:>11} {:>11} {:>10} {:>10}",
+                   "pattern", "engine", "size", "min ms", "median ms", "p99 ms", "MB/s", "matches");
+        if (counted)
+            fmt::print(" {:>6} {:>10} {:>10} {:>10}", "IPC", "br.miss/B", "L1 miss/B", "LLC miss/B");
+        fmt::print("\n");
+    }
+
+    // Compilation first (does not depend on the input), then every size.
+    for (auto const& pattern : patterns)
+        for (auto const& engine : chosen) {
+            Row row{.pattern = pattern.name, .engine = engine.name, .phase = "compile"};
+            try {
+                auto const stats = bench::measure(plan, [&] {
+                    return isize(bool(engine.compile(pattern)));
+                });
+                row.min_ms = stats.min;
+                row.median_ms = stats.median;
+                row.p99_ms = stats.p99;
+                row.mean_ms = stats.mean;
+                row.runs = stats.runs;
+            }
+            catch (std::exception const& e) {
+                row.error = e.what();
+            }
+            print(row);
+            rows.push_back(std::move(row));
+        }
+
+    for (auto const size : bytes) {
+        // The biggest inputs take a while to generate, they are made once per size.
+        Corpus const corpus{size, with_utf16};
+        for (auto const& pattern : patterns)
+            for (auto const& engine : chosen) {
+                Row row{.pattern = pattern.name, .engine = engine.name, .phase = "match", .bytes = size};
+                try {
+                    auto const scan = engine.compile(pattern);
+                    auto const stats = bench::measure(plan, [&] { return scan(corpus); });
+                    row.min_ms = stats.min;
+                    row.median_ms = stats.median;
+                    row.p99_ms = stats.p99;
+                    row.mean_ms = stats.mean;
+                    row.runs = stats.runs;
+                    row.mb_per_s = bench::mb_per_s(size, stats.median);
+                    row.matches = stats.result;
+                    if (counted) {
+                        using namespace perf;
+                        auto const& c = stats.counters;
+                        row.hardware = Hardware::of(c[Cycles], c[Instructions], c[BranchMisses],
+                                                    c[L1Misses], c[LlcMisses], c[PageFaults], size);
+                    }
+                }
+                catch (std::exception const& e) {
+                    row.error = e.what();
+                }
+                print(row);
+                rows.push_back(std::move(row));
+            }
+    }
+
+    if (json)
+        fmt::print("{}\n", glz::prettify(glz::write_json(rows)));
+    return 0;
+}
@@ -0,0 +1,127 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Batch.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <fmt/core.h>
+
+namespace {
+    char const* const Usage =
+        "usage: ccregex-cli [options] file.crgx...\n"
+        "  --engine std,qt,pcre2    engines to run (default: all)\n"
+        "  --granularity G          any, count, offsets or full (default: full)\n"
+        "  --icase                  case insensitive matching\n"
+        "  --document               match the whole source (matches may span lines)\n"
+        "  --jobs N                 number of parallel runs (default: number of cores)\n"
+        "  --quiet                  only stats, without produced lines\n"
+        "  --no-check               don't compare with matches stored in files\n"
+        "  --trace FILE             write spans of runs as Chrome trace-event JSON (Perfetto)\n"
+        "Reports are printed as JSON. Exit status: 0 - all passed, 1 - a check failed or a run\n"
+        "could not be done, 2 - invalid arguments.\n";
+
+    std::optional<Granularity> granularity(std::string_view const name) noexcept {
+        if (name == "any") return Granularity::Any;
+        if (name == "count") return Granularity::Count;
+        if (name == "offsets") return Granularity::Offsets;
+        if (name == "full") return Granularity::Full;
+        return {};
+    }
+
+    strings split(std::string_view text, char const separator) {
+        strings buffer;
+        for (auto pos = text.find(separator); ; pos = text.find(separator)) {
+            if (auto const item = text.substr(0, pos); not item.empty())
+                buffer.emplace_back(item);
+            if (pos == std::string_view::npos)
+                return buffer;
+            text.remove_prefix(pos + 1);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    batch::Options options;
+    strings files;
+    std::string trace_file;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view const arg = argv[i];
+        auto const value = [&]() -> std::string_view {
+            return i + 1 < argc ? argv[++i] : "";
+        };
+        if (arg == "--engine")
+            options.engines = split(value(), ',');
+        else if (arg == "--granularity") {
+            auto const g = granularity(value());
+            if (not g) {
+                fmt::print(stderr, "{}", Usage);
+                return 2;
+            }
+            options.granularity = *g;
+        }
+        else if (arg == "--icase") options.icase = true;
+        else if (arg == "--document") options.document = true;
+        else if (arg == "--quiet") options.results = false;
+        else if (arg == "--no-check") options.check = false;
+        else if (arg == "--trace") trace_file = value();
+        else if (arg == "--jobs") options.jobs = unsigned(std::max(1, std::atoi(std::string(value()).c_str())));
+        else if (arg == "--help" or arg == "-h") {
+            fmt::print("{}", Usage);
+            return 0;
+        }
+        else if (arg.starts_with("--")) {
+            fmt::print(stderr, "unknown option '{}'\n{}", arg, Usage);
+            return 2;
+        }
+        else
+            files.emplace_back(arg);
+    }
+    if (files.empty() or options.engines.empty()) {
+        fmt::print(stderr, "{}", Usage);
+        return 2;
+    }
+
+    if (not trace_file.empty()) {
+        trace::name_thread("main");
+        trace::start();
+    }
+    auto const results = batch::run_all(files, options);
+    if (not trace_file.empty()) {
+        trace::stop();
+        if (not trace::write(trace_file))
+            fmt::print(stderr, "can't write the trace to '{}'\n", trace_file);
+    }
+    fmt::print("{}\n", glz::prettify(glz::write_json(results)));
+
+    auto const ok = std::ranges::all_of(results, [](auto const& result) {
+        return result.error.empty() and result.passed.value_or(true);
+    });
+    return ok ? 0 : 1;
+}
@@ -26,9 +26,16 @@
 -------------------------------------------------------------------*/
 #include <QApplication>
 #include "MainWindow.h"
+#include "Stage.h"
+#include "Trace.h"
 
 int main(int argc, char *argv[]) {
     QApplication a(argc, argv);
+    trace::name_thread("gui");
+#ifdef HEAP_PROFILE
+    // Allocations of stages are shown in the metrics panel.
+    stage::enabled = true;
+#endif
     MainWindow w;
     w.show();
     return QApplication::exec();
@@ -33,6 +33,7 @@
 /*------- struct:
 -------------------------------------------------------------------*/
 struct Match {
+    int line{};
     int nr{};
     int pos{};
     int length{};
@@ -66,6 +67,7 @@ struct Match {
 template<>
 struct glz::meta<Match> {
     static constexpr auto value = object(
+            "line", &Match::line,
             "nr", &Match::nr,
             "pos", &Match::pos,
             "length", &Match::length,
@@ -0,0 +1,314 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../Types.h"
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <vector>
+#include <fmt/core.h>
+#include <glaze/glaze.hpp>
+
+/*------- structs:
+-------------------------------------------------------------------*/
+/// Hardware counters of the scan (user space of the scanning threads).
+struct Hardware {
+    u64 cycles{};
+    u64 instructions{};
+    u64 branch_misses{};
+    u64 l1_misses{};
+    u64 llc_misses{};
+    u64 page_faults{};
+    double ipc{};                   // instructions per cycle
+    double l1_misses_per_byte{};
+    double llc_misses_per_byte{};
+
+    /// Counts with ratios for the scanned bytes.
+    static Hardware of(u64 const cycles, u64 const instructions, u64 const branch_misses,
+                       u64 const l1_misses, u64 const llc_misses, u64 const page_faults, isize const bytes) noexcept {
+        auto const per_byte = [bytes](u64 const n) {
+            return bytes ? double(n) / double(bytes) : 0.0;
+        };
+        return {
+            .cycles = cycles,
+            .instructions = instructions,
+            .branch_misses = branch_misses,
+            .l1_misses = l1_misses,
+            .llc_misses = llc_misses,
+            .page_faults = page_faults,
+            .ipc = cycles ? double(instructions) / double(cycles) : 0.0,
+            .l1_misses_per_byte = per_byte(l1_misses),
+            .llc_misses_per_byte = per_byte(llc_misses)};
+    }
+
+    /// Counters in one line.
+    [[nodiscard]] std::string line() const {
+        return fmt::format("IPC {:.2f}, {} cycles, {} branch misses, L1 {:.4f}/B, LLC {:.4f}/B, {} page faults",
+                           ipc, cycles, branch_misses, l1_misses_per_byte, llc_misses_per_byte, page_faults);
+    }
+};
+
+/// Allocations of a part of the run (counted only by builds with HEAP_PROFILE).
+struct Allocations {
+    isize count{};
+    isize bytes{};          // requested
+    isize peak{};           // the highest growth of the heap above the start
+
+    /// Allocations in one line.
+    /// \param matches - the number of matches of the part (0 - not known).
+    [[nodiscard]] std::string line(isize const matches = 0) const {
+        auto text = fmt::format("{} allocations, {:.1f} KB, peak {:.1f} KB",
+                                count, double(bytes) / 1024., double(peak) / 1024.);
+        if (matches)
+            text += fmt::format(", {:.2f} per match", double(count) / double(matches));
+        return text;
+    }
+};
+
+/// Time and allocations of one stage of the path from the editors to highlights.
+struct StageStats {
+    std::string stage{};
+    isize calls{};
+    double ms{};
+    Allocations heap{};
+};
+
+/// Measurements of one pattern in a run.
+struct PatternStats {
+    std::string pattern{};
+    double compile_ms{};
+    double match_ms{};      // the scan of all sources (with formatting of results)
+    isize bytes{};          // scanned (UTF-8 or UTF-16 text, as the engine sees it)
+    isize lines{};          // sources with a match
+    isize matches{};
+    double mb_per_s{};
+    isize code_size{};      // compiled pattern (PCRE2_INFO_SIZE), 0 - not known
+    isize jit_size{};       // machine code (PCRE2_INFO_JITSIZE), 0 - not JIT-compiled
+    bool cached{};          // the compiled pattern was taken from the cache
+    std::optional<Hardware> hardware{};     // null - counters are not available
+    std::optional<Allocations> heap{};      // null - allocations are not counted
+};
+
+/// Sources whose matching (with all patterns) took at least so long (and less than the next bucket).
+struct Bucket {
+    double from_us{};
+    isize lines{};
+};
+
+/// Source with its time of matching (with all patterns).
+struct SlowLine {
+    isize line{};           // number of the line in the source-editor (from 0)
+    double us{};
+};
+
+/// Measurements of the whole run (all patterns with all sources).
+struct RunStats {
+    std::string engine{};
+    isize sources{};
+    double compile_ms{};
+    double match_ms{};
+    isize bytes{};
+    double mb_per_s{};
+    isize matches{};
+    isize result_bytes{};   // estimate of results held by the views (the peak - they only grow)
+    isize cache_hits{};
+    std::vector<PatternStats> patterns{};
+    std::optional<Hardware> hardware{};     // null - counters are not available (wall time only)
+    std::vector<Bucket> histogram{};    // latency of sources (empty buckets at both ends are omitted)
+    std::vector<SlowLine> slowest{};    // the slowest sources, the slowest first
+    bool document{};                    // one source - the whole document (no latency of lines)
+    std::optional<Allocations> heap{};  // the scan with formatting of results, the peak of the worst pattern
+                                        // (null - not counted)
+    std::vector<StageStats> stages{};   // since the previous run (all tabs), empty - not counted
+
+    /// Convert structure to JSON string
+    [[nodiscard]] std::string to_json(bool const pretty = false) const noexcept {
+        auto buffer = glz::write_json(this);
+        if (not pretty)
+            return buffer;
+        return glz::prettify(buffer);
+    }
+
+    /// Time for humans (the unit depends on the value).
+    [[nodiscard]] static std::string duration(double const us) {
+        if (us < 1) return fmt::format("{:.0f} ns", us * 1000);
+        if (us < 1000) return fmt::format("{:.1f} us", us);
+        return fmt::format("{:.2f} ms", us / 1000);
+    }
+
+    /// Human readable form (one item per line).
+    [[nodiscard]] strings lines() const {
+        auto const kb = [](isize const bytes) {
+            return double(bytes) / 1024.;
+        };
+        strings buffer;
+        buffer.push_back(fmt::format("engine: {}, {} patterns, {} sources", engine, patterns.size(), sources));
+        buffer.push_back(fmt::format("compile: {:.3f} ms, match: {:.3f} ms, scanned: {:.1f} KB, {:.1f} MB/s",
+                                     compile_ms, match_ms, kb(bytes), mb_per_s));
+        buffer.push_back(fmt::format("matches: {}, result memory: {:.1f} KB, cache hits: {}",
+                                     matches, kb(result_bytes), cache_hits));
+        if (hardware)
+            buffer.push_back("counters: " + hardware->line());
+        if (heap)
+            buffer.push_back("heap: " + heap->line(matches));
+        for (auto const& p : patterns) {
+            auto line = fmt::format("'{}': compile {:.3f} ms, match {:.3f} ms, {:.1f} KB, {:.1f} MB/s, {} matches in {} lines",
+                                    p.pattern, p.compile_ms, p.match_ms, kb(p.bytes), p.mb_per_s, p.matches, p.lines);
+            if (p.code_size) line += fmt::format(", code {:.1f} KB", kb(p.code_size));
+            if (p.jit_size) line += fmt::format(", jit {:.1f} KB", kb(p.jit_size));
+            if (p.cached) line += ", cached";
+            buffer.push_back(std::move(line));
+            if (p.hardware)
+                buffer.push_back("    " + p.hardware->line());
+            if (p.heap)
+                buffer.push_back("    " + p.heap->line(p.matches));
+        }
+        if (document)
+            buffer.push_back("latency of lines: not measured (the whole document is one source)");
+        if (not histogram.empty()) {
+            buffer.push_back("latency of lines:");
+            isize most{};
+            for (auto const& bucket : histogram)
+                most = std::max(most, bucket.lines);
+            for (auto const& [from_us, lines] : histogram)
+                buffer.push_back(fmt::format("{:>12} {:>8}  {}", ">= " + duration(from_us), lines,
+                                             std::string(std::size_t((BarWidth * lines + most - 1) / most), '#')));
+        }
+        if (not slowest.empty()) {
+            buffer.push_back("the slowest lines:");
+            for (auto const& [line, us] : slowest)
+                buffer.push_back(fmt::format("  line {}: {}", line + 1, duration(us)));
+        }
+        if (not stages.empty()) {
+            buffer.push_back("stages (inclusive):");
+            for (auto const& [stage, calls, ms, heap] : stages)
+                buffer.push_back(fmt::format("  {:<10} {:>6} calls {:>10.3f} ms  {}", stage, calls, ms, heap.line()));
+        }
+        return buffer;
+    }
+
+    static constexpr isize BarWidth = 40;
+};
+
+/*------- template structs for glz:
+-------------------------------------------------------------------*/
+template<>
+struct glz::meta<Hardware> {
+    using T = Hardware;
+    static constexpr auto value = object(
+            "cycles", &T::cycles,
+            "instructions", &T::instructions,
+            "branch_misses", &T::branch_misses,
+            "l1_misses", &T::l1_misses,
+            "llc_misses", &T::llc_misses,
+            "page_faults", &T::page_faults,
+            "ipc", &T::ipc,
+            "l1_misses_per_byte", &T::l1_misses_per_byte,
+            "llc_misses_per_byte", &T::llc_misses_per_byte
+    );
+};
+
+template<>
+struct glz::meta<Allocations> {
+    using T = Allocations;
+    static constexpr auto value = object(
+            "count", &T::count,
+            "bytes", &T::bytes,
+            "peak", &T::peak
+    );
+};
+
+template<>
+struct glz::meta<StageStats> {
+    using T = StageStats;
+    static constexpr auto value = object(
+            "stage", &T::stage,
+            "calls", &T::calls,
+            "ms", &T::ms,
+            "heap", &T::heap
+    );
+};
+
+template<>
+struct glz::meta<PatternStats> {
+    using T = PatternStats;
+    static constexpr auto value = object(
+            "pattern", &T::pattern,
+            "compile_ms", &T::compile_ms,
+            "match_ms", &T::match_ms,
+            "bytes", &T::bytes,
+            "lines", &T::lines,
+            "matches", &T::matches,
+            "mb_per_s", &T::mb_per_s,
+            "code_size", &T::code_size,
+            "jit_size", &T::jit_size,
+            "cached", &T::cached,
+            "hardware", &T::hardware,
+            "heap", &T::heap
+    );
+};
+
+template<>
+struct glz::meta<Bucket> {
+    using T = Bucket;
+    static constexpr auto value = object(
+            "from_us", &T::from_us,
+            "lines", &T::lines
+    );
+};
+
+template<>
+struct glz::meta<SlowLine> {
+    using T = SlowLine;
+    static constexpr auto value = object(
+            "line", &T::line,
+            "us", &T::us
+    );
+};
+
+template<>
+struct glz::meta<RunStats> {
+    using T = RunStats;
+    static constexpr auto value = object(
+            "engine", &T::engine,
+            "sources", &T::sources,
+            "compile_ms", &T::compile_ms,
+            "match_ms", &T::match_ms,
+            "bytes", &T::bytes,
+            "mb_per_s", &T::mb_per_s,
+            "matches", &T::matches,
+            "result_bytes", &T::result_bytes,
+            "cache_hits", &T::cache_hits,
+            "patterns", &T::patterns,
+            "hardware", &T::hardware,
+            "histogram", &T::histogram,
+            "slowest", &T::slowest,
+            "document", &T::document,
+            "heap", &T::heap,
+            "stages", &T::stages
+    );
+};
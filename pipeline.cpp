@@ -0,0 +1,263 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19/10/2026.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Bench.h"
+#include "Stage.h"
+#include "Event.h"
+#include "EventController.h"
+#include "MainWindow.h"
+#include "WorkingWindow.h"
+#include <QApplication>
+#ifdef PCRE2_REGEX
+    #include "RegexPcre.h"
+#endif
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fmt/core.h>
+
+namespace {
+    char const* const Usage =
+        "usage: ccregex_pipeline [options]\n"
+        "  --tool T           std, qt or pcre2 (default: std)\n"
+        "  --pattern P        the pattern (default: ([a-z]+)@([a-z]+)\\.(com|org|net))\n"
+        "  --granularity G    any, count, offsets, full or ondemand (default: full)\n"
+        "  --lines N,...      numbers of lines of generated documents (default: 1000,10000,100000)\n"
+        "  --warmup N         not measured runs (default: 1)\n"
+        "  --reps N           measured runs (default: 5)\n"
+        "The run goes the path of the Run button: editors -> prepare -> scan -> events -> matches-view\n"
+        "and highlighting. Times are inclusive (scan includes post, dispatch includes append and highlight),\n"
+        "allocations are per run (medians) and counted by the thread of the stage, the peak is the highest\n"
+        "growth of the heap in one call of the stage. QT_QPA_PLATFORM is 'offscreen' unless it is set.\n";
+
+    /// Row of the report - one stage, all repetitions.
+    struct Samples {
+        std::vector<double> ms{};
+        std::vector<double> calls{};
+        std::vector<double> allocations{};
+        std::vector<double> bytes{};
+        std::vector<double> peak{};
+
+        void add(double const ns, i64 const calls_, i64 const allocations_, i64 const bytes_, i64 const peak_) {
+            ms.push_back(ns / 1e6);
+            calls.push_back(double(calls_));
+            allocations.push_back(double(allocations_));
+            bytes.push_back(double(bytes_));
+            peak.push_back(double(peak_));
+        }
+    };
+
+    std::optional<Granularity> granularity(std::string_view const name) noexcept {
+        if (name == "any") return Granularity::Any;
+        if (name == "count") return Granularity::Count;
+        if (name == "offsets") return Granularity::Offsets;
+        if (name == "full") return Granularity::Full;
+        if (name == "ondemand") return Granularity::OnDemand;
+        return {};
+    }
+
+    std::vector<isize> numbers(std::string_view text) {
+        std::vector<isize> buffer;
+        for (auto pos = text.find(','); ; pos = text.find(',')) {
+            if (auto const n = std::atoll(std::string(text.substr(0, pos)).c_str()); n > 0)
+                buffer.push_back(isize(n));
+            if (pos == std::string_view::npos)
+                return buffer;
+            text.remove_prefix(pos + 1);
+        }
+    }
+
+    /// Document of so many generated lines.
+    strings document(isize const n) {
+        // Lines are about 60 bytes long, there is some reserve.
+        auto const text = bench::text(n * 96);
+        strings lines;
+        lines.reserve(n);
+        std::string_view rest = text;
+        while (isize(lines.size()) < n) {
+            auto const pos = rest.find('\n');
+            if (pos == std::string_view::npos)
+                break;
+            lines.emplace_back(rest.substr(0, pos));
+            rest.remove_prefix(pos + 1);
+        }
+        return lines;
+    }
+
+    /// Deliver everything that was posted (the controller's queue, highlighting, repaints).
+    void drain() {
+        for (int i = 0; i < 3; ++i) {
+            QCoreApplication::sendPostedEvents();
+            QCoreApplication::processEvents();
+        }
+    }
+
+    /// Request of the run, the same as the Run button sends.
+    void request(int const tool, Granularity const results) {
+        int const limit = 0;
+        int const group = 0;
+        bool const document = false;
+        bool const sliced = false;
+        auto& controller = EventController::instance();
+        switch (tool) {
+            case tool::Qt:
+                controller.send_event(event::RunRequest, tool, int(results), limit, group, document, sliced,
+                                      int(QRegularExpression::NoPatternOption));
+                break;
+#ifdef PCRE2_REGEX
+            case tool::Pcre2:
+                controller.send_event(event::RunRequest, tool, int(results), limit, group, document, sliced,
+                                      u32(PCRE2_UTF));
+                break;
+#endif
+            default: {
+                type::StdSyntaxOption const grammar = std::regex_constants::ECMAScript;
+                controller.send_event(event::RunRequest, tool, int(results), limit, group, document, sliced,
+                                      grammar, qstr("[]"));
+            }
+        }
+    }
+
+    void print(std::string_view const name, Samples const& samples) {
+        auto const time = bench::summary(samples.ms);
+        auto const calls = bench::summary(samples.calls);
+        auto const allocations = bench::summary(samples.allocations);
+        auto const bytes = bench::summary(samples.bytes);
+        auto const peak = bench::summary(samples.peak);
+        fmt::print("  {:<14} {:>9.0f} {:>11.3f} {:>11.3f} {:>11.3f} {:>12.0f} {:>12.1f} {:>12.1f}\n",
+                   name, calls.median, time.min, time.median, time.p99, allocations.median, bytes.median / 1024.,
+                   peak.median / 1024.);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    int tool = tool::Std;
+    std::string pattern = "([a-z]+)@([a-z]+)\\.(com|org|net)";
+    Granularity results = Granularity::Full;
+    std::vector<isize> sizes{1'000, 10'000, 100'000};
+    bench::Plan plan{.warmup = 1, .reps = 5};
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view const arg = argv[i];
+        auto const value = [&]() -> std::string_view {
+            return i + 1 < argc ? argv[++i] : "";
+        };
+        if (arg == "--tool") {
+            auto const name = value();
+            tool = name == "qt" ? tool::Qt : name == "pcre2" ? tool::Pcre2 : tool::Std;
+        }
+        else if (arg == "--pattern") pattern = value();
+        else if (arg == "--granularity") {
+            auto const g = granularity(value());
+            if (not g) {
+                fmt::print(stderr, "{}", Usage);
+                return 2;
+            }
+            results = *g;
+        }
+        else if (arg == "--lines") sizes = numbers(value());
+        else if (arg == "--warmup") plan.warmup = std::max(0, std::atoi(std::string(value()).c_str()));
+        else if (arg == "--reps") plan.reps = std::max(1, std::atoi(std::string(value()).c_str()));
+        else if (arg == "--help" or arg == "-h") {
+            fmt::print("{}", Usage);
+            return 0;
+        }
+        else {
+            fmt::print(stderr, "unknown option '{}'\n{}", arg, Usage);
+            return 2;
+        }
+    }
+
+    MainWindow window;
+    window.show();
+    auto const ww = window.findChild<WorkingWindow*>();
+    if (not ww) {
+        fmt::print(stderr, "no working window\n");
+        return 1;
+    }
+
+    for (auto const n : sizes) {
+        Content content;
+        content.regex = {pattern};
+        content.source = document(n);
+        ww->set_content(content);
+        drain();
+
+        std::array<Samples, stage::Count> stages{};
+        Samples scan_only, total;
+        for (int rep = 0; rep < plan.warmup + plan.reps; ++rep) {
+            stage::reset();
+            stage::enabled = true;
+            auto const allocations = stage::heap::allocations.load();
+            auto const bytes = stage::heap::bytes.load();
+            auto const start = bench::clock::now();
+
+            // What saving does, then what the Run button does.
+            [[maybe_unused]] auto const saved = ww->content();
+            request(tool, results);
+            drain();
+
+            auto const ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(bench::clock::now() - start).count());
+            stage::enabled = false;
+            if (rep < plan.warmup)
+                continue;
+            i64 peak{};
+            for (int id = 0; id < stage::Count; ++id) {
+                auto const s = stage::snapshot(stage::Id(id));
+                stages[id].add(double(s.ns), s.calls, s.allocations, s.bytes, s.peak);
+                peak = std::max(peak, s.peak);
+            }
+            total.add(ns, 1, stage::heap::allocations.load() - allocations, stage::heap::bytes.load() - bytes, peak);
+            // Matching and formatting of lines, without posting them.
+            auto const scan = stage::snapshot(stage::Scan);
+            auto const post = stage::snapshot(stage::Post);
+            scan_only.add(double(scan.ns - post.ns), scan.calls, scan.allocations - post.allocations, scan.bytes - post.bytes,
+                          scan.peak);
+        }
+
+        fmt::print("{} lines, {} bytes, {} runs:\n", n, [&] {
+            isize bytes{};
+            for (auto const& line : content.source) bytes += isize(line.size()) + 1;
+            return bytes;
+        }(), plan.reps);
+        fmt::print("  {:<14} {:>9} {:>11} {:>11} {:>11} {:>12} {:>12} {:>12}\n",
+                   "stage", "calls", "min ms", "median ms", "p99 ms", "allocations", "KB", "peak KB");
+        for (int id = 0; id < stage::Count; ++id)
+            print(stage::Names[id], stages[id]);
+        print("match+format", scan_only);
+        print("total", total);
+    }
+    return 0;
+}